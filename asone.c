@@ -56,6 +56,7 @@ __attribute__((externally_visible)) void LowLevelInit(void);
 #include "xeq.c"
 #include "serial.c"
 #include "matrix.c"
+#include "solve.c"
 #include "xrom.c"
 #include "stopwatch.c"
 #include "printer.c"
@@ -0,0 +1,1080 @@
+/* This file is part of 34S.
+ * 
+ * 34S is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * 34S is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with 34S.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *  Micro benchmarks of the function tables for the console emulator
+ *
+ *  bench [-t <ms>] [-s <save file>] [-c <baseline file>] [-r <percent>] [<name> ...]
+ *
+ *  Every entry of monfuncs, dyfuncs and trifuncs is executed as an opcode
+ *  over a fixed set of arguments, the real and complex versions in single
+ *  and double precision, the integer versions in 64 bit two's complement.
+ *  Each case runs for at least the given time (20 ms by default) and
+ *  reports the mean time per call and the deepest C stack it used.  There
+ *  is no heap in the firmware, the stack is the memory that matters.
+ *
+ *  -s writes the results to a file, -c compares against such a file and
+ *  marks every case which got slower by more than -r percent (10 by
+ *  default); the exit status is then 1.  Names restrict the run to cases
+ *  whose key contains one of them.
+ *
+ *  xbench below measures the XROM routines by instruction count, sincos
+ *  checks sincosTaylor against the series it replaced and dist the C
+ *  distributions against their XROM routines and factor the factoring
+ *  engine against plain trial division.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "xeq.h"
+#include "decn.h"
+#include "int.h"
+#include "storage.h"
+#include "xrom.h"
+
+#ifdef INCLUDE_BENCHMARKS
+
+#define BENCH_MS	20		// Default time per case
+#define BENCH_SLOWER	10		// Default regression threshold in percent
+#define BENCH_STACK	(256 * 1024)	// Stack the measured calls run on
+#define BENCH_KEY	48
+#define STACK_MARK	0xa5
+
+extern const char *pretty(unsigned char);
+
+/*
+ *  Arguments, one row per call starting with X.  Complex functions take
+ *  pairs, dyadic complex functions get X, Y, Z and T.
+ */
+struct bench_args {
+	int width, rows;
+	const char *const *v;
+};
+
+static const char *const mon_real[] = { "0.3", "1.7", "-2.4", "12.5", "0.001", "97" };
+static const char *const dya_real[] = {
+	"3", "2",	"1.9", "0.7",	"2", "-3.2",	"0.25", "100",	"5", "17",
+};
+static const char *const tri_real[] = {
+	"3", "2", "0.5",	"1.9", "0.7", "1",	"5", "4", "3",	"2", "0.25", "10",
+};
+static const char *const mon_cmplx[] = {
+	"0.3", "0.4",	"1.7", "-2.2",	"-2.4", "0.9",	"12.5", "3",
+};
+static const char *const dya_cmplx[] = {
+	"0.3", "0.4", "2", "1",		"1.7", "-2.2", "-0.5", "3",
+	"-2.4", "0.9", "12", "-7",	"12.5", "3", "0.1", "0.2",
+};
+static const char *const mon_int[] = { "3", "17", "1000", "65521", "123456789", "-42" };
+static const char *const dya_int[] = {
+	"5", "17",	"7", "1000",	"65521", "123456789",	"3", "-42",
+};
+static const char *const tri_int[] = {
+	"11", "7", "3",		"1000003", "65521", "123456789",	"97", "-42", "5",
+};
+
+#define ARGS(w, a)	{ w, sizeof(a) / sizeof(*a) / (w), a }
+static const struct bench_args args_mon_real = ARGS(1, mon_real);
+static const struct bench_args args_dya_real = ARGS(2, dya_real);
+static const struct bench_args args_tri_real = ARGS(3, tri_real);
+static const struct bench_args args_mon_cmplx = ARGS(2, mon_cmplx);
+static const struct bench_args args_dya_cmplx = ARGS(4, dya_cmplx);
+static const struct bench_args args_mon_int = ARGS(1, mon_int);
+static const struct bench_args args_dya_int = ARGS(2, dya_int);
+static const struct bench_args args_tri_int = ARGS(3, tri_int);
+#undef ARGS
+
+/*
+ *  Saved results of an earlier run
+ */
+static struct bench_result {
+	char key[BENCH_KEY];
+	double ns;
+	unsigned int stack;
+} *Baseline;
+static int BaselineCount;
+
+static unsigned long long bench_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ *  Stack use is measured by running the call once on a stack of its own
+ *  which is filled with a pattern beforehand.  The context switch keeps
+ *  the thread and with it the calculator state.
+ */
+static ucontext_t StackCaller, StackCallee;
+static opcode StackOp;
+
+static void stack_run(void) {
+	xeq(StackOp);
+}
+
+static unsigned int stack_used(const opcode op) {
+	unsigned char *const stack = malloc(BENCH_STACK);
+	unsigned int i;
+
+	if (stack == NULL)
+		return 0;
+	memset(stack, STACK_MARK, BENCH_STACK);
+	getcontext(&StackCallee);
+	StackCallee.uc_stack.ss_sp = stack;
+	StackCallee.uc_stack.ss_size = BENCH_STACK;
+	StackCallee.uc_link = &StackCaller;
+	makecontext(&StackCallee, stack_run, 0);
+	StackOp = op;
+	swapcontext(&StackCaller, &StackCallee);
+
+	for (i = 0; i < BENCH_STACK && stack[i] == STACK_MARK; i++)
+		;
+	free(stack);
+	return BENCH_STACK - i;
+}
+
+static void bench_load(const struct bench_args *a, int row) {
+	const char *const *v = a->v + row * a->width;
+	int i;
+
+	for (i = 0; i < a->width; i++) {
+		if (is_intmode()) {
+			const long long int n = strtoll(v[i], NULL, 10);
+
+			set_reg_n_int(regX_idx + i, build_value(n < 0 ? -n : n, n < 0));
+		}
+		else {
+			decNumber x;
+
+			decNumberFromString(&x, v[i], &Ctx);
+			setRegister(regX_idx + i, &x);
+		}
+	}
+}
+
+/*
+ *  Run one opcode over all argument rows until the time is used up
+ */
+static void bench_op(const opcode op, const struct bench_args *a, unsigned long long budget,
+		     double *ns, unsigned int *stack) {
+	unsigned long long total = 0, calls = 0, t;
+	unsigned int used;
+	int row;
+
+	*stack = 0;
+	for (row = 0; row < a->rows; row++) {
+		bench_load(a, row);
+		used = stack_used(op);
+		if (used > *stack)
+			*stack = used;
+	}
+	do {
+		for (row = 0; row < a->rows; row++) {
+			bench_load(a, row);
+			t = bench_now();
+			xeq(op);
+			total += bench_now() - t;
+			calls++;
+		}
+	} while (total < budget);
+	*ns = (double) total / calls;
+}
+
+/*
+ *  Key of a case: table, kind, name and precision
+ */
+static char *bench_key(char *key, const char *table, const char *kind, opcode op, const char *mode) {
+	char buf[16];
+	const char *p = prt(op, buf);
+	char *q = key + sprintf(key, "%s.%s.", table, kind);
+
+	for (; *p != '\0' && q < key + BENCH_KEY - 16; p++) {
+		const char *m = pretty(*p);
+
+		if (*p == ' ' || *p == '\006')		// Space or narrow space
+			*q++ = '_';
+		else if (m != NULL)
+			q += sprintf(q, "[%s]", m);
+		else
+			*q++ = *p;
+	}
+	sprintf(q, ".%s", mode);
+	return key;
+}
+
+static int bench_selected(const char *key, int argc, char *argv[]) {
+	int i;
+
+	if (argc == 0)
+		return 1;
+	for (i = 0; i < argc; i++)
+		if (strstr(key, argv[i]) != NULL)
+			return 1;
+	return 0;
+}
+
+static int bench_load_baseline(const char *name) {
+	FILE *f = fopen(name, "r");
+	char line[128];
+
+	if (f == NULL) {
+		fprintf(stderr, "cannot open baseline %s\n", name);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		struct bench_result r;
+
+		if (sscanf(line, "%47s %lf %u", r.key, &r.ns, &r.stack) != 3)
+			continue;
+		if ((BaselineCount & 63) == 0)
+			Baseline = realloc(Baseline, (BaselineCount + 64) * sizeof(*Baseline));
+		Baseline[BaselineCount++] = r;
+	}
+	fclose(f);
+	return 0;
+}
+
+static const struct bench_result *bench_find(const char *key) {
+	int i;
+
+	for (i = 0; i < BaselineCount; i++)
+		if (strcmp(Baseline[i].key, key) == 0)
+			return Baseline + i;
+	return NULL;
+}
+
+/*
+ *  Set up the calculator for a mode: s, d or i
+ */
+static void bench_mode(int mode) {
+	xeq(OP_NIL | OP_FLOAT);
+	xeq(OP_NIL | (mode == 'd' ? OP_DBLON : OP_DBLOFF));
+	if (mode == 'i') {
+		xeq(RARG(RARG_WS, 64));
+		xeq(OP_NIL | OP_2COMP);
+		xeq(RARG(RARG_BASE, 10));
+	}
+}
+
+int bench(int argc, char *argv[]) {
+	static const char *const modes[] = { "s", "d", "i" };
+	unsigned long long budget = BENCH_MS * 1000000ULL;
+	const char *save = NULL;
+	double slower = BENCH_SLOWER;
+	int regressions = 0, cases = 0, m, k, f;
+	FILE *out = NULL;
+
+	for (; argc > 1 && argv[0][0] == '-'; argc -= 2, argv += 2) {
+		if (strcmp(argv[0], "-t") == 0)
+			budget = strtoull(argv[1], NULL, 10) * 1000000ULL;
+		else if (strcmp(argv[0], "-s") == 0)
+			save = argv[1];
+		else if (strcmp(argv[0], "-c") == 0) {
+			if (bench_load_baseline(argv[1]))
+				return 2;
+		}
+		else if (strcmp(argv[0], "-r") == 0)
+			slower = atof(argv[1]);
+		else
+			break;
+	}
+	if (save != NULL && (out = fopen(save, "w")) == NULL) {
+		fprintf(stderr, "cannot write %s\n", save);
+		return 2;
+	}
+
+	batch_mode = 1;		// No display output
+	reset();
+	init_34s();
+
+	printf("%-*s %12s %8s%s\n", BENCH_KEY - 16, "CASE", "ns/op", "stack",
+		BaselineCount ? "     baseline  change" : "");
+	for (m = 0; m < 3; m++) {
+		const int mode = *modes[m];
+
+		bench_mode(mode);
+		for (k = 0; k < 3; k++) {
+			const int n = k == 0 ? NUM_MONADIC : k == 1 ? NUM_DYADIC : NUM_TRIADIC;
+			const char *const table = k == 0 ? "mon" : k == 1 ? "dya" : "tri";
+
+			for (f = 0; f < n; f++) {
+				struct {
+					const char *kind;
+					opcode op;
+					int present;
+					const struct bench_args *args;
+				} c[2];
+				int i;
+
+				// The real or integer version and the complex one
+				if (k == 0) {
+					c[0].present = mode == 'i' ? ! isNULL(monfuncs[f].monint) : ! isNULL(monfuncs[f].mondreal);
+					c[0].op = OP_MON | f;
+					c[0].args = mode == 'i' ? &args_mon_int : &args_mon_real;
+					c[1].present = mode != 'i' && ! isNULL(monfuncs[f].mondcmplx);
+					c[1].op = OP_CMON | f;
+					c[1].args = &args_mon_cmplx;
+				}
+				else if (k == 1) {
+					c[0].present = mode == 'i' ? ! isNULL(dyfuncs[f].dydint) : ! isNULL(dyfuncs[f].dydreal);
+					c[0].op = OP_DYA | f;
+					c[0].args = mode == 'i' ? &args_dya_int : &args_dya_real;
+					c[1].present = mode != 'i' && ! isNULL(dyfuncs[f].dydcmplx);
+					c[1].op = OP_CDYA | f;
+					c[1].args = &args_dya_cmplx;
+				}
+				else {
+					c[0].present = mode == 'i' ? ! isNULL(trifuncs[f].triint) : ! isNULL(trifuncs[f].trireal);
+					c[0].op = OP_TRI | f;
+					c[0].args = mode == 'i' ? &args_tri_int : &args_tri_real;
+					c[1].present = 0;
+				}
+				c[0].kind = mode == 'i' ? "int" : "real";
+				c[1].kind = "cmplx";
+
+				for (i = 0; i < 2; i++) {
+					char key[BENCH_KEY];
+					const struct bench_result *b;
+					unsigned int stack;
+					double ns;
+
+					if (! c[i].present)
+						continue;
+					bench_key(key, table, c[i].kind, c[i].op, modes[m]);
+					if (! bench_selected(key, argc, argv))
+						continue;
+					bench_op(c[i].op, c[i].args, budget, &ns, &stack);
+					cases++;
+					printf("%-*s %12.1f %8u", BENCH_KEY - 16, key, ns, stack);
+					b = bench_find(key);
+					if (b != NULL) {
+						const double change = 100.0 * (ns - b->ns) / b->ns;
+
+						printf(" %12.1f %+6.1f%%%s", b->ns, change, change > slower ? " !" : "");
+						if (change > slower)
+							regressions++;
+					}
+					putchar('\n');
+					if (out != NULL)
+						fprintf(out, "%s %.1f %u\n", key, ns, stack);
+				}
+			}
+		}
+	}
+	if (out != NULL)
+		fclose(out);
+	printf("%d cases", cases);
+	if (BaselineCount)
+		printf(", %d slower by more than %g%%", regressions, slower);
+	putchar('\n');
+	free(Baseline);
+	return regressions != 0;
+}
+
+/*
+ *  End to end benchmark of the XROM routines
+ *
+ *  xbench [-t <ms>] [-b <budget file>] [-s <save file>] [<name> ...]
+ *
+ *  Every table entry implemented in XROM and the XROM commands which call
+ *  a user function (solver, integrator, sums, products and derivatives) are
+ *  run through the interpreter over a fixed corpus.  The user function is
+ *  f(x) = x^2 - 2 under label 01.  Each case reports the instructions
+ *  executed for one pass over its corpus, the mean host time per call and
+ *  the last error or message code displayed.
+ *
+ *  -b compares against a budget file: a case fails when it executes more
+ *  instructions than its budget or raises a different error; the exit
+ *  status is then 1.  Budgets which match no case that ran, for functions
+ *  no longer in XROM, are listed as warnings.  -s writes the current counts
+ *  as a new budget file.
+ */
+#define XBENCH_MS	5		// Default time per case
+#define XBENCH_LBL	1		// Label of the user function
+
+static const char *const xrom_real[] = { "0.3", "-0.2", "1.7", "12.5" };
+static const char *const xrom_dist[] = { "0.05", "0.3", "0.7", "0.95" };
+static const char *const xrom_guess[] = { "1", "2",	"-3", "0" };
+static const char *const xrom_limits[] = { "1", "0",	"2.5", "-1" };
+static const char *const xrom_count[] = { "10", "25" };
+static const char *const xrom_point[] = { "1.5", "-0.4" };
+static const char *const xrom_quad[] = { "2", "-3", "1",	"-1", "0.5", "4" };
+static const char *const xrom_prime[] = { "1000", "123456" };
+
+#define ARGS(w, a)	{ w, sizeof(a) / sizeof(*a) / (w), a }
+static const struct bench_args args_xrom_real = ARGS(1, xrom_real);
+static const struct bench_args args_xrom_dist = ARGS(1, xrom_dist);
+static const struct bench_args args_xrom_guess = ARGS(2, xrom_guess);
+static const struct bench_args args_xrom_limits = ARGS(2, xrom_limits);
+static const struct bench_args args_xrom_count = ARGS(1, xrom_count);
+static const struct bench_args args_xrom_point = ARGS(1, xrom_point);
+static const struct bench_args args_xrom_quad = ARGS(3, xrom_quad);
+static const struct bench_args args_xrom_prime = ARGS(1, xrom_prime);
+#undef ARGS
+
+/*
+ *  XROM commands which are not in the function tables
+ */
+static const struct {
+	opcode op;
+	const struct bench_args *args;
+} xrom_cmds[] = {
+	{ RARG(RARG_SOLVE, XBENCH_LBL),		&args_xrom_guess },
+	{ RARG(RARG_INTG, XBENCH_LBL),		&args_xrom_limits },
+	{ RARG(RARG_SUM, XBENCH_LBL),		&args_xrom_count },
+	{ RARG(RARG_PROD, XBENCH_LBL),		&args_xrom_count },
+	{ RARG(RARG_DERIV, XBENCH_LBL),		&args_xrom_point },
+	{ RARG(RARG_2DERIV, XBENCH_LBL),	&args_xrom_point },
+	{ OP_NIL | OP_QUAD,			&args_xrom_quad },
+	{ OP_NIL | OP_NEXTPRIME,		&args_xrom_prime },
+};
+
+static int is_xrom_function(const void *fp) {
+	const s_opcode *xp = (const s_opcode *) ((uintptr_t) fp & ~1);
+
+	return xp >= xrom && xp < xrom + xrom_size;
+}
+
+/*
+ *  Run an opcode including any user code it calls and return the
+ *  number of instructions executed
+ */
+static unsigned long long xbench_call(const opcode op) {
+	const unsigned long long n = instruction_count;
+
+	xeq(op);
+	if (Running)
+		xeqprog();
+	Running = Pause = 0;
+	return instruction_count - n;
+}
+
+static void xbench_op(const opcode op, const struct bench_args *a, unsigned long long budget,
+		      double *ns, unsigned long long *steps, unsigned int *error) {
+	unsigned long long total = 0, calls = 0, t;
+	int row;
+
+	*steps = 0;
+	*error = ERR_NONE;
+	for (row = 0; row < a->rows; row++) {
+		bench_load(a, row);
+		batch_error = ERR_NONE;
+		*steps += xbench_call(op);
+		if (batch_error != ERR_NONE)
+			*error = batch_error;
+	}
+	do {
+		for (row = 0; row < a->rows; row++) {
+			bench_load(a, row);
+			t = bench_now();
+			xbench_call(op);
+			total += bench_now() - t;
+			calls++;
+		}
+	} while (total < budget);
+	*ns = (double) total / calls;
+}
+
+/*
+ *  Budgets: key, instruction count and error code per line
+ */
+static struct xbench_budget {
+	char key[BENCH_KEY];
+	unsigned long long steps;
+	unsigned int error;
+	int used;
+} *Budgets;
+static int BudgetCount;
+
+static int xbench_load_budgets(const char *name) {
+	FILE *f = fopen(name, "r");
+	char line[128];
+
+	if (f == NULL) {
+		fprintf(stderr, "cannot open budget file %s\n", name);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		struct xbench_budget b;
+
+		if (sscanf(line, "%47s %llu %u", b.key, &b.steps, &b.error) != 3)
+			continue;
+		b.used = 0;
+		if ((BudgetCount & 63) == 0)
+			Budgets = realloc(Budgets, (BudgetCount + 64) * sizeof(*Budgets));
+		Budgets[BudgetCount++] = b;
+	}
+	fclose(f);
+	return 0;
+}
+
+static const struct xbench_budget *xbench_find(const char *key) {
+	int i;
+
+	for (i = 0; i < BudgetCount; i++)
+		if (strcmp(Budgets[i].key, key) == 0) {
+			Budgets[i].used = 1;
+			return Budgets + i;
+		}
+	return NULL;
+}
+
+/*
+ *  Enter the user function: LBL 01 x^2 # 2 - RTN in program mode
+ */
+static void xbench_program(void) {
+	State2.runmode = 0;
+	clpall();
+	stoprog(RARG(RARG_LBL, XBENCH_LBL));
+	stoprog(OP_MON | OP_SQR);
+	stoprog(RARG(RARG_INTNUM, 2));
+	stoprog(OP_DYA | OP_SUB);
+	stoprog(OP_NIL | OP_RTN);
+	State2.runmode = 1;
+	clrretstk_pc();
+}
+
+/*
+ *  Parameters of the distributions in J and K
+ */
+static void xbench_parameters(void) {
+	decNumber x;
+
+	decNumberFromString(&x, "0.5", &Ctx);
+	setRegister(regJ_idx, &x);
+	decNumberFromString(&x, "10", &Ctx);
+	setRegister(regK_idx, &x);
+}
+
+int xbench(int argc, char *argv[]) {
+	static const char *const modes[] = { "s", "i" };
+	unsigned long long budget = XBENCH_MS * 1000000ULL;
+	const char *save = NULL;
+	int failures = 0, cases = 0, unused = 0, m, k, f, i;
+	FILE *out = NULL;
+
+	for (; argc > 1 && argv[0][0] == '-'; argc -= 2, argv += 2) {
+		if (strcmp(argv[0], "-t") == 0)
+			budget = strtoull(argv[1], NULL, 10) * 1000000ULL;
+		else if (strcmp(argv[0], "-s") == 0)
+			save = argv[1];
+		else if (strcmp(argv[0], "-b") == 0) {
+			if (xbench_load_budgets(argv[1]))
+				return 2;
+		}
+		else
+			break;
+	}
+	if (save != NULL && (out = fopen(save, "w")) == NULL) {
+		fprintf(stderr, "cannot write %s\n", save);
+		return 2;
+	}
+
+	batch_mode = 1;
+	reset();
+	init_34s();
+	xbench_program();
+
+	printf("%-*s %10s %12s %5s%s\n", BENCH_KEY - 16, "CASE", "steps", "ns/call", "error",
+		BudgetCount ? "     budget" : "");
+	for (m = 0; m < 2; m++) {
+		const int mode = *modes[m];
+		const int ncmds = mode == 'i' ? 0 : sizeof(xrom_cmds) / sizeof(*xrom_cmds);
+
+		bench_mode(mode);
+		xbench_parameters();
+		for (k = 0; k < 4; k++) {
+			const int n = k == 0 ? NUM_MONADIC : k == 1 ? NUM_DYADIC : k == 2 ? NUM_TRIADIC : ncmds;
+			const char *const table = k == 0 ? "mon" : k == 1 ? "dya" : k == 2 ? "tri" : "cmd";
+
+			for (f = 0; f < n; f++) {
+				struct {
+					const char *kind;
+					opcode op;
+					const void *fp;
+					const struct bench_args *args;
+				} c[2];
+
+				c[0].kind = mode == 'i' ? "int" : "real";
+				c[1].kind = "cmplx";
+				c[1].fp = NULL;
+				if (k == 0) {
+					c[0].fp = mode == 'i' ? (const void *) monfuncs[f].monint : (const void *) monfuncs[f].mondreal;
+					c[0].op = OP_MON | f;
+					c[0].args = mode == 'i' ? &args_mon_int
+						  : f >= OP_pdf_Q && f <= OP_cdfu_C ? &args_xrom_dist : &args_xrom_real;
+					if (mode != 'i')
+						c[1].fp = (const void *) monfuncs[f].mondcmplx;
+					c[1].op = OP_CMON | f;
+					c[1].args = &args_mon_cmplx;
+				}
+				else if (k == 1) {
+					c[0].fp = mode == 'i' ? (const void *) dyfuncs[f].dydint : (const void *) dyfuncs[f].dydreal;
+					c[0].op = OP_DYA | f;
+					c[0].args = mode == 'i' ? &args_dya_int : &args_dya_real;
+					if (mode != 'i')
+						c[1].fp = (const void *) dyfuncs[f].dydcmplx;
+					c[1].op = OP_CDYA | f;
+					c[1].args = &args_dya_cmplx;
+				}
+				else if (k == 2) {
+					c[0].fp = mode == 'i' ? (const void *) trifuncs[f].triint : (const void *) trifuncs[f].trireal;
+					c[0].op = OP_TRI | f;
+					c[0].args = mode == 'i' ? &args_tri_int : &args_tri_real;
+				}
+				else {
+					c[0].fp = xrom;
+					c[0].op = xrom_cmds[f].op;
+					c[0].args = xrom_cmds[f].args;
+				}
+
+				for (i = 0; i < 2; i++) {
+					char key[BENCH_KEY];
+					const struct xbench_budget *b;
+					unsigned long long steps;
+					unsigned int error;
+					double ns;
+
+					if (! is_xrom_function(c[i].fp))
+						continue;
+					bench_key(key, table, c[i].kind, c[i].op, modes[m]);
+					if (! bench_selected(key, argc, argv))
+						continue;
+					xbench_op(c[i].op, c[i].args, budget, &ns, &steps, &error);
+					cases++;
+					printf("%-*s %10llu %12.1f %5u", BENCH_KEY - 16, key, steps, ns, error);
+					b = xbench_find(key);
+					if (b != NULL) {
+						const int fail = steps > b->steps || error != b->error;
+
+						printf(" %10llu%s", b->steps, fail ? " !" : "");
+						failures += fail;
+					}
+					else if (BudgetCount)
+						printf(" %10s", "new");
+					putchar('\n');
+					if (out != NULL)
+						fprintf(out, "%s %llu %u\n", key, steps, error);
+				}
+			}
+		}
+	}
+	if (out != NULL)
+		fclose(out);
+	for (i = 0; i < BudgetCount; i++)
+		if (! Budgets[i].used && bench_selected(Budgets[i].key, argc, argv)) {
+			printf("warning: budget %s matches no case\n", Budgets[i].key);
+			unused++;
+		}
+	printf("%d cases", cases);
+	if (BudgetCount)
+		printf(", %d over budget", failures);
+	if (unused)
+		printf(", %d unused budgets", unused);
+	putchar('\n');
+	free(Budgets);
+	return failures != 0;
+}
+
+/*
+ *  Check sincosTaylor against the plain Taylor series it replaced
+ *
+ *  sincos [<count>]
+ *
+ *  Runs both over a fixed set of angles in (-2 pi, 2 pi) plus the
+ *  awkward ones near multiples of pi/4 and 1/16.  A result differs when
+ *  it is further from the series value than 1e-38 relative or 1e-46
+ *  absolute, the series itself loses that much near the zeros.
+ */
+#define SINCOS_COUNT	2000
+
+static double sincos_error(const decNumber *x, const decNumber *ref, double *rel) {
+	decNumber d, e;
+	char buf[64];
+	double a, r;
+
+	dn_subtract(&d, x, ref);
+	dn_abs(&e, &d);
+	decNumberToString(&e, buf);
+	a = atof(buf);
+	decNumberToString(ref, buf);
+	r = atof(buf);
+	if (r < 0)
+		r = -r;
+	*rel = r > 1e-10 ? a / r : 0;
+	return a;
+}
+
+int sincos_check(int argc, char *argv[]) {
+	static const char *const special[] = {
+		"0", "1e-30", "-1e-30", "0.0625", "0.0624999999", "0.1875", "0.8125",
+		"0.7853981633974483096156608458198757210", "1.570796326794896619231321691639751442",
+		"-1.570796326794896619231321691639751442", "3.141592653589793238462643383279502884",
+		"4.712388980384689857693965074919254326", "6.283185307179586476925286766559005768",
+		"-3.141592653589793238462643383279502884", "2.356194490192344928846982537459627163",
+		"1", "-1", "0.5", "3", "6", "-6.28",
+	};
+	const int count = argc > 0 ? atoi(argv[0]) : SINCOS_COUNT;
+	const int n = sizeof(special) / sizeof(*special);
+	unsigned long long t, tnew = 0, tref = 0;
+	unsigned int seed = 34;
+	double max_rel = 0, max_abs = 0, rel, a;
+	int i, j, bad = 0;
+
+	batch_mode = 1;
+	reset();
+	init_34s();
+
+	for (i = 0; i < n + count; i++) {
+		decNumber x, s, c, rs, rc;
+		char buf[48];
+
+		if (i < n)
+			decNumberFromString(&x, special[i], &Ctx);
+		else {
+			// A fixed pseudo random angle with a varying number of digits
+			seed = seed * 1103515245 + 12345;
+			sprintf(buf, "%.*f", 3 + (int) (seed >> 8) % 17, ((seed >> 4) % 1000000) * 12.566370614359 / 1e6 - 6.2831853071796);
+			decNumberFromString(&x, buf, &Ctx);
+		}
+		t = bench_now();
+		sincosTaylor(&x, &s, &c);
+		tnew += bench_now() - t;
+		t = bench_now();
+		sincos_series(&x, &rs, &rc);
+		tref += bench_now() - t;
+
+		for (j = 0; j < 2; j++) {
+			a = sincos_error(j ? &c : &s, j ? &rc : &rs, &rel);
+			if (a > max_abs)
+				max_abs = a;
+			if (rel > max_rel)
+				max_rel = rel;
+			if (rel > 1e-38 && a > 1e-46) {
+				decNumberToString(&x, buf);
+				printf("%s(%s) differs by %g\n", j ? "cos" : "sin", buf, a);
+				bad++;
+			}
+		}
+	}
+	printf("%d angles, max difference %g relative %g absolute, %d beyond tolerance\n",
+		n + count, max_rel, max_abs, bad);
+	printf("%.0f ns per call, %.0f ns for the series\n",
+		(double) tnew / (n + count), (double) tref / (n + count));
+	return bad != 0;
+}
+
+#ifdef INCLUDE_NATIVE_DISTRIBUTIONS
+/*
+ *  Check the C distributions against the XROM routines they replace
+ *
+ *  dist [<name> ...]
+ *
+ *  Every distribution with a C version runs over a set of parameters in J
+ *  and K and of arguments in X, in single and double precision with flag D
+ *  clear and set, once in C and once through its XROM routine.  A case
+ *  differs when only one of the two raises an error or their results are
+ *  further apart than 1e-14 relative in single and 1e-24 in double
+ *  precision.  The error codes may differ: XROM can stop on an infinite
+ *  intermediate where C carries on to a NaN.  The XROM routines round every
+ *  step to the working precision, the C versions do not, so the results
+ *  need not agree to the last digit.  Names restrict the run to functions
+ *  containing one of them, the exit status is 1 when a case differs.
+ */
+static const char *const dist_none[] = { "0", "0" };
+static const char *const dist_normal[] = {
+	"0", "1",	"2", "0.5",	"-1", "3",	"0", "0",	"0", "-1",
+};
+static const char *const dist_t[] = { "1", "0",	"2.5", "0",	"7", "0",	"30", "0",	"0", "0" };
+static const char *const dist_chi2[] = { "1", "0",	"2", "0",	"5", "0",	"12", "0",	"2.5", "0" };
+static const char *const dist_f[] = {
+	"1", "1",	"3", "7",	"10", "2.5",	"20", "40",	"0", "3",
+};
+static const char *const dist_poisson[] = { "0.5", "0",	"3", "0",	"12.5", "0",	"40", "0",	"-1", "0" };
+static const char *const dist_pois2[] = {
+	"0.3", "10",	"0.05", "100",	"1", "4.5",	"1.5", "3",
+};
+static const char *const dist_binomial[] = {
+	"0.3", "10",	"0.5", "25",	"0.05", "100",	"0.9", "7",	"0.5", "4.5",
+};
+
+static const char *const dist_x[] = {
+	"-3", "-0.5", "0", "0.3", "1", "1.7", "4", "12.5", "40", "1e-20",
+};
+static const char *const dist_p[] = {
+	"0", "1e-10", "0.001", "0.05", "0.3", "0.5", "0.7", "0.95", "0.999", "1", "-0.1",
+};
+
+#define ARGS(w, a)	{ w, sizeof(a) / sizeof(*a) / (w), a }
+static const struct bench_args args_dist_none = ARGS(2, dist_none);
+static const struct bench_args args_dist_normal = ARGS(2, dist_normal);
+static const struct bench_args args_dist_t = ARGS(2, dist_t);
+static const struct bench_args args_dist_chi2 = ARGS(2, dist_chi2);
+static const struct bench_args args_dist_f = ARGS(2, dist_f);
+static const struct bench_args args_dist_poisson = ARGS(2, dist_poisson);
+static const struct bench_args args_dist_pois2 = ARGS(2, dist_pois2);
+static const struct bench_args args_dist_binomial = ARGS(2, dist_binomial);
+static const struct bench_args args_dist_x = ARGS(1, dist_x);
+static const struct bench_args args_dist_p = ARGS(1, dist_p);
+#undef ARGS
+
+#define DIST(f, xr, params)								\
+	{ #f, OP_MON | OP_ ## f, XROM_ ## xr, &args_dist_ ## params }
+
+static const struct {
+	const char *name;
+	opcode op;
+	unsigned short int label;
+	const struct bench_args *params;
+} dist_funcs[] = {
+	DIST(pdf_Q, PDF_Q, none),		DIST(cdf_Q, CDF_Q, none),
+	DIST(cdfu_Q, CDFU_Q, none),		DIST(qf_Q, QF_Q, none),
+	DIST(pdf_N, PDF_NORMAL, normal),	DIST(cdf_N, CDF_NORMAL, normal),
+	DIST(cdfu_N, CDFU_NORMAL, normal),	DIST(qf_N, QF_NORMAL, normal),
+	DIST(pdf_T, PDF_T, t),			DIST(cdf_T, CDF_T, t),
+	DIST(cdfu_T, CDFU_T, t),		DIST(qf_T, QF_T, t),
+	DIST(pdf_chi2, PDF_CHI2, chi2),		DIST(cdf_chi2, CDF_CHI2, chi2),
+	DIST(cdfu_chi2, CDFU_CHI2, chi2),	DIST(qf_chi2, QF_CHI2, chi2),
+	DIST(pdf_F, PDF_F, f),			DIST(cdf_F, CDF_F, f),
+	DIST(cdfu_F, CDFU_F, f),		DIST(qf_F, QF_F, f),
+	DIST(pdf_Plam, PDF_POISSON, poisson),	DIST(cdf_Plam, CDF_POISSON, poisson),
+	DIST(cdfu_Plam, CDFU_POISSON, poisson),	DIST(qf_Plam, QF_POISSON, poisson),
+	DIST(pdf_P, PDF_POIS2, pois2),		DIST(cdf_P, CDF_POIS2, pois2),
+	DIST(cdfu_P, CDFU_POIS2, pois2),	DIST(qf_P, QF_POIS2, pois2),
+	DIST(pdf_B, PDF_BINOMIAL, binomial),	DIST(cdf_B, CDF_BINOMIAL, binomial),
+	DIST(cdfu_B, CDFU_BINOMIAL, binomial),	DIST(qf_B, QF_BINOMIAL, binomial),
+};
+#undef DIST
+
+/*
+ *  Run one case and return its time, the result and the error
+ */
+static unsigned long long dist_run(const opcode op, const s_opcode *xp, const struct bench_args *a,
+				   int row, decNumber *r, unsigned int *error) {
+	unsigned long long t;
+
+	bench_load(a, row);
+	batch_error = ERR_NONE;
+	t = bench_now();
+	if (xp == NULL)
+		xeq(op);
+	else
+		xeq_xrom_monadic(op, (void *) xp);
+	if (Running)
+		xeqprog();
+	t = bench_now() - t;
+	Running = Pause = 0;
+	getX(r);
+	*error = batch_error;
+	return t;
+}
+
+static double dist_difference(const decNumber *a, const decNumber *b) {
+	decNumber d, e;
+	char buf[64];
+	double x, y;
+
+	if (decNumberIsNaN(a) || decNumberIsNaN(b))
+		return decNumberIsNaN(a) && decNumberIsNaN(b) ? 0 : 1;
+	if (decNumberIsInfinite(a) || decNumberIsInfinite(b))
+		return dn_eq(a, b) ? 0 : 1;
+	dn_subtract(&d, a, b);
+	dn_abs(&e, &d);
+	decNumberToString(&e, buf);
+	x = atof(buf);
+	dn_abs(&e, b);
+	decNumberToString(&e, buf);
+	y = atof(buf);
+	return y > 1e-300 ? x / y : x;
+}
+
+int dist_check(int argc, char *argv[]) {
+	const int n = sizeof(dist_funcs) / sizeof(*dist_funcs);
+	int i, k, bad = 0;
+
+	batch_mode = 1;
+	reset();
+	init_34s();
+
+	for (k = 0; k < 4; k++) {
+		const char *const mode = k < 2 ? "s" : "d";
+		const double tolerance = k < 2 ? 1e-14 : 1e-24;
+
+		bench_mode(*mode);
+		put_user_flag(NAN_FLAG, k & 1);
+		for (i = 0; i < n; i++) {
+			const struct bench_args *pa = dist_funcs[i].params;
+			const struct bench_args *xa = *dist_funcs[i].name == 'q' ? &args_dist_p : &args_dist_x;
+			const s_opcode *xp = xrom + dist_funcs[i].label - XROM_START;
+			unsigned long long tc = 0, tx = 0;
+			double worst = 0;
+			int p, row, cases = 0, differ = 0;
+
+			if (!bench_selected(dist_funcs[i].name, argc, argv))
+				continue;
+			for (p = 0; p < pa->rows; p++) {
+				for (row = 0; row < xa->rows; row++) {
+					decNumber a, rc, rx;
+					unsigned int ec, ex;
+					double d;
+
+					decNumberFromString(&a, pa->v[2 * p], &Ctx);
+					setRegister(regJ_idx, &a);
+					decNumberFromString(&a, pa->v[2 * p + 1], &Ctx);
+					setRegister(regK_idx, &a);
+					tc += dist_run(dist_funcs[i].op, NULL, xa, row, &rc, &ec);
+					tx += dist_run(dist_funcs[i].op, xp, xa, row, &rx, &ex);
+					cases++;
+
+					d = ec == ERR_NONE && ex == ERR_NONE ? dist_difference(&rc, &rx) : 0;
+					if (d > worst)
+						worst = d;
+					if ((ec == ERR_NONE) != (ex == ERR_NONE) || d > tolerance) {
+						char bc[64], bx[64];
+
+						decNumberToString(&rc, bc);
+						decNumberToString(&rx, bx);
+						printf("%s.%s%s J=%s K=%s X=%s: C %s (error %u), XROM %s (error %u)\n",
+							dist_funcs[i].name, mode, k & 1 ? "D" : "", pa->v[2 * p], pa->v[2 * p + 1],
+							xa->v[row], bc, ec, bx, ex);
+						differ++;
+					}
+				}
+			}
+			printf("%-12s %-2s %3d cases, max difference %-9.3g %3d differ, %8.0f ns in C, %8.0f ns in XROM\n",
+				dist_funcs[i].name, k & 1 ? (k < 2 ? "sD" : "dD") : mode, cases, worst, differ,
+				(double) tc / cases, (double) tx / cases);
+			bad += differ;
+		}
+	}
+	return bad != 0;
+}
+#endif
+
+#ifdef INCLUDE_FACTOR
+/*
+ *  Time FACTOR and check its results
+ *
+ *  factor [<count>]
+ *
+ *  A corpus of hard inputs, semiprimes whose smaller factor grows from
+ *  three to ten digits, squares and cubes of primes and large primes, is
+ *  factored by doFactor and each result is compared with the least prime
+ *  factor the corpus was built from.  Each line shows the number, the least
+ *  prime factor and the time taken.
+ *  Then <count> (1000 by default) pseudo random numbers below 1e12 are
+ *  checked against the plainest possible trial division.  The exit status
+ *  is 1 when a result of the new engine is wrong.
+ */
+#define FACTOR_COUNT	1000
+
+static unsigned long long next_prime(unsigned long long n) {
+	while (! isPrime(n))
+		n++;
+	return n;
+}
+
+static unsigned long long factor_reference(unsigned long long n) {
+	unsigned long long d;
+
+	if (n > 3 && (n & 1) == 0)
+		return 2;
+	for (d = 3; d * d <= n; d += 2)
+		if (n % d == 0)
+			return d;
+	return n;
+}
+
+static unsigned long long factor_time(unsigned long long (*f)(unsigned long long), unsigned long long n,
+		unsigned long long *r) {
+	unsigned long long t = bench_now();
+
+	*r = (*f)(n);
+	return bench_now() - t;
+}
+
+int factor_check(int argc, char *argv[]) {
+	static const unsigned long long small[] = {
+		1009ULL, 65537ULL, 1000003ULL, 9999991ULL, 10000019ULL, 123456791ULL,
+		1000000007ULL, 2147483647ULL, 4294967291ULL,
+	};
+	const int count = argc > 0 ? atoi(argv[0]) : FACTOR_COUNT;
+	const int ns = sizeof(small) / sizeof(*small);
+	unsigned long long corpus[3 * sizeof(small) / sizeof(*small) + 4], expect[sizeof(corpus) / sizeof(*corpus)];
+	unsigned long long r, t = 0;
+	unsigned long long seed = 34;
+	int i, nc = 0, bad = 0;
+
+	batch_mode = 1;
+	reset();
+	init_34s();
+
+	for (i = 0; i < ns; i++) {
+		const unsigned long long p = small[i];
+		unsigned long long q = next_prime(0xffffffffffffffffULL / p / 3);
+
+		corpus[nc] = p * q;						// unbalanced, filling 62 bits
+		expect[nc++] = p < q ? p : q;
+		q = next_prime(p + 2);
+		if (q <= 0xffffffffffffffffULL / p) {				// two close factors
+			corpus[nc] = p * q;
+			expect[nc++] = p;
+		}
+		if (p < 2642245ULL) {						// cubes below 2^64
+			corpus[nc] = p * p * p;
+			expect[nc++] = p;
+		}
+	}
+	corpus[nc] = 4294967291ULL * 4294967291ULL;
+	expect[nc++] = 4294967291ULL;
+	corpus[nc] = expect[nc] = 18446744073709551557ULL;		// the largest 64 bit prime
+	nc++;
+	corpus[nc] = expect[nc] = next_prime(1000000000000000000ULL);
+	nc++;
+
+	for (i = 0; i < nc; i++) {
+		const unsigned long long dn = factor_time(&doFactor, corpus[i], &r);
+
+		printf("%20llu %10llu %10.0f ns%s\n", corpus[i], r, (double) dn,
+			r != expect[i] ? " wrong" : "");
+		t += dn;
+		bad += r != expect[i];
+	}
+	printf("%d hard cases, %.0f us\n", nc, t / 1e3);
+
+	t = 0;
+	for (i = 0; i < count; i++) {
+		unsigned long long n;
+
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		n = (seed >> 24) % 1000000000000ULL;
+		t += factor_time(&doFactor, n, &r);
+		if (r != factor_reference(n)) {
+			printf("%llu: %llu wrong\n", n, r);
+			bad++;
+		}
+	}
+	printf("%d numbers below 1e12, %.0f ns per call\n", count, (double) t / (count ? count : 1));
+	return bad != 0;
+}
+#endif
+
+#endif
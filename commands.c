@@ -31,6 +31,7 @@
 #include "printer.h"
 #endif
 #include "matrix.h"
+#include "solve.h"
 #ifdef INCLUDE_STOPWATCH
 #include "stopwatch.h"
 #endif
@@ -61,6 +62,32 @@
 #define XARG(name)	(FP_RARG) XPTR(name)
 #define XMULTI(name)	(FP_MULTI) XPTR(name)
 
+/* Distributions with a C version in the host builds
+ */
+#ifdef INCLUDE_NATIVE_DISTRIBUTIONS
+#define DMR(fn, name)	&fn
+#else
+#define DMR(fn, name)	XMR(name)
+#endif
+
+/* Orthogonal polynomials with a C version in the host builds
+ */
+#ifdef INCLUDE_NATIVE_ORTHOPOLYS
+#define ODR(fn, name)	&fn
+#define OTR(fn, name)	&fn
+#else
+#define ODR(fn, name)	XDR(name)
+#define OTR(fn, name)	XTR(name)
+#endif
+
+/* Fibonacci numbers with a C version in the host builds
+ */
+#ifdef INCLUDE_NATIVE_FIBONACCI
+#define FMR(fn, name)	&fn
+#else
+#define FMR(fn, name)	XMR(name)
+#endif
+
 
 /* Infrared command wrappers to maintain binary compatibility across images */
 #ifdef INFRARED
@@ -160,7 +187,7 @@ const struct monfunc monfuncs[ NUM_MONADIC ] = {
 	FUNC(OP_SQR,	&decNumberSquare,	XMC(cpx_x2),	&intSqr,	"x\232",	"x^2")
 	FUNC(OP_CUBE,	&decNumberCube,		XMC(cpx_x3),	&intCube,	"x\200",	"x^3")
 	FUNC(OP_CUBERT,	&decNumberCubeRoot,	&cmplxCubeRoot,	&intMonadic,	"\200\003",	"CROOT")
-	FUNC(OP_FIB,	XMR(FIB),		XMC(CPX_FIB),	&intFib,	"FIB",		CNULL)
+	FUNC(OP_FIB,	FMR(decNumberFib, FIB),	XMC(CPX_FIB),	&intFib,	"FIB",		CNULL)
 	FUNC(OP_2DEG,	&decNumberDRG,		NOFN,		NOFN,		"\015DEG",	">DEG")
 	FUNC(OP_2RAD,	&decNumberDRG,		NOFN,		NOFN,		"\015RAD",	">RAD")
 	FUNC(OP_2GRAD,	&decNumberDRG,		NOFN,		NOFN,		"\015GRAD",	">GRAD")
@@ -198,39 +225,39 @@ const struct monfunc monfuncs[ NUM_MONADIC ] = {
 	FUNC(OP_CCONJ,	NOFN,			XMC(cpx_CONJ),	NOFN,		"\024CONJ",	"cCONJ")
 	FUNC(OP_ERF,	XMR(ERF),		NOFN,		NOFN,		"erf",		CNULL)
 	FUNC(OP_ERFC,	XMR(ERFC),		NOFN,		NOFN,		"erfc",		CNULL)
-	FUNC(OP_pdf_Q,	XMR(PDF_Q), 		NOFN,		NOFN,		"\264(x)",	"phi(x)")
-	FUNC(OP_cdf_Q,	XMR(CDF_Q), 		NOFN,		NOFN,		"\224(x)",	"PHI(x)")
-	FUNC(OP_qf_Q,	XMR(QF_Q),  		NOFN,		NOFN,		"\224\235(p)",	"INV-PHI")
-	FUNC(OP_pdf_chi2, XMR(PDF_CHI2),	NOFN,		NOFN,		"\265\232\276",	"chi2-p")
-	FUNC(OP_cdf_chi2, XMR(CDF_CHI2),	NOFN,		NOFN,		"\265\232",	"CHI2")
-	FUNC(OP_qf_chi2,  XMR(QF_CHI2),		NOFN,		NOFN,		"\265\232INV",	"INV-CHI2")
-	FUNC(OP_pdf_T,	XMR(PDF_T),		NOFN,		NOFN,		"t\276(x)",	"t-p(x)")
-	FUNC(OP_cdf_T,	XMR(CDF_T),		NOFN,		NOFN,		"t(x)",		CNULL)
-	FUNC(OP_qf_T,	XMR(QF_T),		NOFN,		NOFN,		"t\235(p)",	"INV-t")
-	FUNC(OP_pdf_F,	XMR(PDF_F),		NOFN,		NOFN,		"F\276(x)",	"F-p(x)")
-	FUNC(OP_cdf_F,	XMR(CDF_F),		NOFN,		NOFN,		"F(x)",		CNULL)
-	FUNC(OP_qf_F,	XMR(QF_F),		NOFN,		NOFN,		"F\235(p)",	"INV-F")
+	FUNC(OP_pdf_Q,	DMR(pdf_Q, PDF_Q), 		NOFN,		NOFN,		"\264(x)",	"phi(x)")
+	FUNC(OP_cdf_Q,	DMR(cdf_Q, CDF_Q), 		NOFN,		NOFN,		"\224(x)",	"PHI(x)")
+	FUNC(OP_qf_Q,	DMR(qf_Q, QF_Q),  		NOFN,		NOFN,		"\224\235(p)",	"INV-PHI")
+	FUNC(OP_pdf_chi2, DMR(pdf_chi2, PDF_CHI2),	NOFN,		NOFN,		"\265\232\276",	"chi2-p")
+	FUNC(OP_cdf_chi2, DMR(cdf_chi2, CDF_CHI2),	NOFN,		NOFN,		"\265\232",	"CHI2")
+	FUNC(OP_qf_chi2,  DMR(qf_chi2, QF_CHI2),		NOFN,		NOFN,		"\265\232INV",	"INV-CHI2")
+	FUNC(OP_pdf_T,	DMR(pdf_T, PDF_T),		NOFN,		NOFN,		"t\276(x)",	"t-p(x)")
+	FUNC(OP_cdf_T,	DMR(cdf_T, CDF_T),		NOFN,		NOFN,		"t(x)",		CNULL)
+	FUNC(OP_qf_T,	DMR(qf_T, QF_T),		NOFN,		NOFN,		"t\235(p)",	"INV-t")
+	FUNC(OP_pdf_F,	DMR(pdf_F, PDF_F),		NOFN,		NOFN,		"F\276(x)",	"F-p(x)")
+	FUNC(OP_cdf_F,	DMR(cdf_F, CDF_F),		NOFN,		NOFN,		"F(x)",		CNULL)
+	FUNC(OP_qf_F,	DMR(qf_F, QF_F),		NOFN,		NOFN,		"F\235(p)",	"INV-F")
 	FUNC(OP_pdf_WB,	XMR(PDF_WEIB),		NOFN,		NOFN,		"Weibl\276",	"Weibl-p")
 	FUNC(OP_cdf_WB,	XMR(CDF_WEIB),		NOFN,		NOFN,		"Weibl",	CNULL)
 	FUNC(OP_qf_WB,	XMR(QF_WEIB),		NOFN,		NOFN,		"Weibl\235",	"INV-Weibl")
 	FUNC(OP_pdf_EXP,XMR(PDF_EXPON),		NOFN,		NOFN,		"Expon\276",	"Expon-p")
 	FUNC(OP_cdf_EXP,XMR(CDF_EXPON),		NOFN,		NOFN,		"Expon",	CNULL)
 	FUNC(OP_qf_EXP,	XMR(QF_EXPON),		NOFN,		NOFN,		"Expon\235",	"INV-Expon")
-	FUNC(OP_pdf_B,	XMR(PDF_BINOMIAL),	NOFN,		NOFN,		"Binom\276",	"Binom-p")
-	FUNC(OP_cdf_B,	XMR(CDF_BINOMIAL),	NOFN,		NOFN,		"Binom",	CNULL)
-	FUNC(OP_qf_B,	XMR(QF_BINOMIAL),	NOFN,		NOFN,		"Binom\235",	"INV-Binom")
-	FUNC(OP_pdf_Plam, XMR(PDF_POISSON),	NOFN,		NOFN,		"Pois\252\276",	"Pois-p")
-	FUNC(OP_cdf_Plam, XMR(CDF_POISSON),	NOFN,		NOFN,		"Pois\252",	"Pois")
-	FUNC(OP_qf_Plam,  XMR(QF_POISSON),	NOFN,		NOFN,		"Pois\252\235",	"INV-Pois")
-	FUNC(OP_pdf_P,	XMR(PDF_POIS2),		NOFN,		NOFN,		"Poiss\276",	"Pois2-p")
-	FUNC(OP_cdf_P,	XMR(CDF_POIS2),		NOFN,		NOFN,		"Poiss",	"Pois2")
-	FUNC(OP_qf_P,	XMR(QF_POIS2),		NOFN,		NOFN,		"Poiss\235",	"INV-Pois2")
+	FUNC(OP_pdf_B,	DMR(pdf_B, PDF_BINOMIAL),	NOFN,		NOFN,		"Binom\276",	"Binom-p")
+	FUNC(OP_cdf_B,	DMR(cdf_B, CDF_BINOMIAL),	NOFN,		NOFN,		"Binom",	CNULL)
+	FUNC(OP_qf_B,	DMR(qf_B, QF_BINOMIAL),	NOFN,		NOFN,		"Binom\235",	"INV-Binom")
+	FUNC(OP_pdf_Plam, DMR(pdf_Plam, PDF_POISSON),	NOFN,		NOFN,		"Pois\252\276",	"Pois-p")
+	FUNC(OP_cdf_Plam, DMR(cdf_Plam, CDF_POISSON),	NOFN,		NOFN,		"Pois\252",	"Pois")
+	FUNC(OP_qf_Plam,  DMR(qf_Plam, QF_POISSON),	NOFN,		NOFN,		"Pois\252\235",	"INV-Pois")
+	FUNC(OP_pdf_P,	DMR(pdf_P, PDF_POIS2),		NOFN,		NOFN,		"Poiss\276",	"Pois2-p")
+	FUNC(OP_cdf_P,	DMR(cdf_P, CDF_POIS2),		NOFN,		NOFN,		"Poiss",	"Pois2")
+	FUNC(OP_qf_P,	DMR(qf_P, QF_POIS2),		NOFN,		NOFN,		"Poiss\235",	"INV-Pois2")
 	FUNC(OP_pdf_G,	XMR(PDF_GEOM),		NOFN,		NOFN,		"Geom\276",	"Geom-p")
 	FUNC(OP_cdf_G,	XMR(CDF_GEOM),		NOFN,		NOFN,		"Geom",		CNULL)
 	FUNC(OP_qf_G,	XMR(QF_GEOM),		NOFN,		NOFN,		"Geom\235",	"INV-Geom")
-	FUNC(OP_pdf_N,	XMR(PDF_NORMAL),	NOFN,		NOFN,		"Norml\276",	"Norml-p")
-	FUNC(OP_cdf_N,	XMR(CDF_NORMAL),	NOFN,		NOFN,		"Norml",	CNULL)
-	FUNC(OP_qf_N,	XMR(QF_NORMAL),		NOFN,		NOFN,		"Norml\235",	"INV-Norml")
+	FUNC(OP_pdf_N,	DMR(pdf_N, PDF_NORMAL),	NOFN,		NOFN,		"Norml\276",	"Norml-p")
+	FUNC(OP_cdf_N,	DMR(cdf_N, CDF_NORMAL),	NOFN,		NOFN,		"Norml",	CNULL)
+	FUNC(OP_qf_N,	DMR(qf_N, QF_NORMAL),		NOFN,		NOFN,		"Norml\235",	"INV-Norml")
 	FUNC(OP_pdf_LN,	XMR(PDF_LOGNORMAL),	NOFN,		NOFN,		"LgNrm\276",	"LgNorm-p")
 	FUNC(OP_cdf_LN,	XMR(CDF_LOGNORMAL),	NOFN,		NOFN,		"LgNrm",	CNULL)
 	FUNC(OP_qf_LN,	XMR(QF_LOGNORMAL),	NOFN,		NOFN,		"LgNrm\235",	"INV-LgNorm")
@@ -240,17 +267,17 @@ const struct monfunc monfuncs[ NUM_MONADIC ] = {
 	FUNC(OP_pdf_C,	XMR(PDF_CAUCHY),	NOFN,		NOFN,		"Cauch\276",	"Cauch-p")
 	FUNC(OP_cdf_C,	XMR(CDF_CAUCHY),	NOFN,		NOFN,		"Cauch",	CNULL)
 	FUNC(OP_qf_C,	XMR(QF_CAUCHY),		NOFN,		NOFN,		"Cauch\235",	"INV-Cauch")
-	FUNC(OP_cdfu_Q,	XMR(CDFU_Q),		NOFN,		NOFN,		"\224\277(x)",	"Q-u")
-	FUNC(OP_cdfu_chi2, XMR(CDFU_CHI2),	NOFN,		NOFN,		"\265\232\277",	"CHI2-u")
-	FUNC(OP_cdfu_T,	XMR(CDFU_T),		NOFN,		NOFN,		"t\277(x)",	"t-u")
-	FUNC(OP_cdfu_F,	XMR(CDFU_F),		NOFN,		NOFN,		"F\277(x)",	"F-u")
+	FUNC(OP_cdfu_Q,	DMR(cdfu_Q, CDFU_Q),		NOFN,		NOFN,		"\224\277(x)",	"Q-u")
+	FUNC(OP_cdfu_chi2, DMR(cdfu_chi2, CDFU_CHI2),	NOFN,		NOFN,		"\265\232\277",	"CHI2-u")
+	FUNC(OP_cdfu_T,	DMR(cdfu_T, CDFU_T),		NOFN,		NOFN,		"t\277(x)",	"t-u")
+	FUNC(OP_cdfu_F,	DMR(cdfu_F, CDFU_F),		NOFN,		NOFN,		"F\277(x)",	"F-u")
 	FUNC(OP_cdfu_WB, XMR(CDFU_WEIB),	NOFN,		NOFN,		"Weibl\277",	"Weibl-u")
 	FUNC(OP_cdfu_EXP, XMR(CDFU_EXPON),	NOFN,		NOFN,		"Expon\277",	"Expon-u")
-	FUNC(OP_cdfu_B,	XMR(CDFU_BINOMIAL),	NOFN,		NOFN,		"Binom\277",	"Binom-u")
-	FUNC(OP_cdfu_Plam, XMR(CDFU_POISSON),	NOFN,		NOFN,		"Pois\252\277",	"Pois-u")
-	FUNC(OP_cdfu_P,	XMR(CDFU_POIS2),	NOFN,		NOFN,		"Poiss\277",	"Pois2-u")
+	FUNC(OP_cdfu_B,	DMR(cdfu_B, CDFU_BINOMIAL),	NOFN,		NOFN,		"Binom\277",	"Binom-u")
+	FUNC(OP_cdfu_Plam, DMR(cdfu_Plam, CDFU_POISSON),	NOFN,		NOFN,		"Pois\252\277",	"Pois-u")
+	FUNC(OP_cdfu_P,	DMR(cdfu_P, CDFU_POIS2),	NOFN,		NOFN,		"Poiss\277",	"Pois2-u")
 	FUNC(OP_cdfu_G,	XMR(CDFU_GEOM),		NOFN,		NOFN,		"Geom\277",	"Geom-u")
-	FUNC(OP_cdfu_N,	XMR(CDFU_NORMAL),	NOFN,		NOFN,		"Norml\277",	"Norml-u")
+	FUNC(OP_cdfu_N,	DMR(cdfu_N, CDFU_NORMAL),	NOFN,		NOFN,		"Norml\277",	"Norml-u")
 	FUNC(OP_cdfu_LN, XMR(CDFU_LOGNORMAL),	NOFN,		NOFN,		"LgNrm\277",	"LgNrm-u")
 	FUNC(OP_cdfu_LG, XMR(CDFU_LOGIT),	NOFN,		NOFN,		"Logis\277",	"Logis-u")
 	FUNC(OP_cdfu_C,	XMR(CDFU_CAUCHY),	NOFN,		NOFN,		"Cauch\277",	"Cauch-u")
@@ -280,9 +307,6 @@ const struct monfunc monfuncs[ NUM_MONADIC ] = {
 
 #ifdef INCLUDE_EASTER
 	FUNC(OP_EASTER,	&dateEaster,		NOFN,		NOFN,		"EASTER",	CNULL)
-#endif
-#ifdef INCLUDE_FACTOR
-	FUNC(OP_FACTOR,	&decFactor,		NOFN,		&intFactor,	"FACTOR",	CNULL)
 #endif
 	FUNC(OP_DATE_YEAR, &dateExtraction,	NOFN,		NOFN,		"YEAR",		CNULL)
 	FUNC(OP_DATE_MONTH, &dateExtraction,	NOFN,		NOFN,		"MONTH",	CNULL)
@@ -308,6 +332,9 @@ const struct monfunc monfuncs[ NUM_MONADIC ] = {
 #ifdef INCLUDE_XROM_DIGAMMA
 	FUNC(OP_DIGAMMA,XMR(DIGAMMA),		XMC(CPX_DIGAMMA),	NOFN,	"\226",		"DIGAMMA")
 #endif
+#ifdef INCLUDE_FACTOR
+	FUNC(OP_FACTOR,	&decFactor,		NOFN,		&intFactor,	"FACTOR",	CNULL)
+#endif
 #undef FUNC
 };
 
@@ -381,12 +408,12 @@ const struct dyfunc dyfuncs[ NUM_DYADIC ] = {
 	FUNC(OP_DTADD,	XDR(DATE_ADD),		NOFN,		NOFN,		"DAYS+",	CNULL)
 	FUNC(OP_DTDIF,	XDR(DATE_DELTA),	NOFN,		NOFN,		"\203DAYS",	"DDAYS")
 
-	FUNC(OP_LEGENDRE_PN,	XDR(LegendrePn),	NOFN,	NOFN,		"P\275",	"Pn")
-	FUNC(OP_CHEBYCHEV_TN,	XDR(ChebychevTn),	NOFN,	NOFN,		"T\275",	"Tn")
-	FUNC(OP_CHEBYCHEV_UN,	XDR(ChebychevUn),	NOFN,	NOFN,		"U\275",	"Un")
-	FUNC(OP_LAGUERRE,	XDR(LaguerreLn),	NOFN,	NOFN,		"L\275",	"Ln")
-	FUNC(OP_HERMITE_HE,	XDR(HermiteHe),		NOFN,	NOFN,		"H\275",	"Hn")
-	FUNC(OP_HERMITE_H,	XDR(HermiteH),		NOFN,	NOFN,		"H\275\276",	"Hnp")
+	FUNC(OP_LEGENDRE_PN,	ODR(decNumberPolyPn, LegendrePn),NOFN,	NOFN,		"P\275",	"Pn")
+	FUNC(OP_CHEBYCHEV_TN,	ODR(decNumberPolyTn, ChebychevTn),NOFN,	NOFN,		"T\275",	"Tn")
+	FUNC(OP_CHEBYCHEV_UN,	ODR(decNumberPolyUn, ChebychevUn),NOFN,	NOFN,		"U\275",	"Un")
+	FUNC(OP_LAGUERRE,	ODR(decNumberPolyLn, LaguerreLn),NOFN,	NOFN,		"L\275",	"Ln")
+	FUNC(OP_HERMITE_HE,	ODR(decNumberPolyHEn, HermiteHe),NOFN,	NOFN,		"H\275",	"Hn")
+	FUNC(OP_HERMITE_H,	ODR(decNumberPolyHn, HermiteH),NOFN,	NOFN,		"H\275\276",	"Hnp")
 #ifdef INCLUDE_XROOT
 	FUNC(OP_XROOT,	&decNumberXRoot,	&cmplxXRoot,	&intDyadic,	"\234\003y",	"XROOT")
 #endif
@@ -433,7 +460,7 @@ const struct trifunc trifuncs[ NUM_TRIADIC ] = {
 	FUNC(OP_MULADD, 	&decNumberMAdd,		&intMAdd,		"\034+",	"*+")
 #endif
 	FUNC(OP_PERMRR,		XTR(PERMMR),		(FP_TRIADIC_INT) NOFN,	"%MRR",		CNULL)
-        FUNC(OP_GEN_LAGUERRE,   XTR(LaguerreLnA),	(FP_TRIADIC_INT) NOFN,	"L\275\240",	"LnAlpha")
+        FUNC(OP_GEN_LAGUERRE,   OTR(decNumberPolyLnAlpha, LaguerreLnA),	(FP_TRIADIC_INT) NOFN,	"L\275\240",	"LnAlpha")
 
 	FUNC(OP_MAT_MUL,	&matrix_multiply,	(FP_TRIADIC_INT) NOFN,	"M\034",	"M*")
 	FUNC(OP_MAT_GADD,	&matrix_genadd,		(FP_TRIADIC_INT) NOFN,	"M+\034",	"M+*")
@@ -444,6 +471,9 @@ const struct trifunc trifuncs[ NUM_TRIADIC ] = {
 	FUNC(OP_MULMOD, 	(FP_TRIADIC_REAL) NOFN,	&intmodop,		"\034MOD",	CNULL)
 	FUNC(OP_EXPMOD, 	(FP_TRIADIC_REAL) NOFN,	&intmodop,		"^MOD",		CNULL)
 #endif
+#ifdef MATRIX_LU_DECOMP
+	FUNC(OP_MAT_LU_SOLVE,	&matrix_lu_solve,	(FP_TRIADIC_INT) NOFN,	"LUSOLV",	CNULL)
+#endif
 #undef FUNC
 };
 
@@ -715,15 +745,29 @@ const struct niladic niladics[ NUM_NILADIC ] = {
 #if defined(INCLUDE_YREG_CODE) && !defined(YREG_ALWAYS_ON)
 	FUNC0(OP_SHOWY,		XNIL(SHOW_Y_REG),	"YDON",		CNULL)
 	FUNC0(OP_HIDEY,		XNIL(HIDE_Y_REG),	"YDOFF",	CNULL)
+#else
+	FUNC0(OP_SHOWY,		NOFN,			"???",		CNULL)
+	FUNC0(OP_HIDEY,		NOFN,			"???",		CNULL)
 #endif
 
 #ifdef INCLUDE_STOPWATCH
 	FUNC0(OP_STOPWATCH,	&stopwatch,		"STOPW",	CNULL)
+#else
+	FUNC0(OP_STOPWATCH,	NOFN,			"???",		CNULL)
 #endif
 #ifdef _DEBUG
 	FUNC0(OP_DEBUG,		XNIL(DBG),		"DBG",		CNULL)
+#else
+	FUNC0(OP_DEBUG,		NOFN,			"???",		CNULL)
 #endif
 
+	FUNC0(OP_SLVI,		&solver,		"SLVI",		CNULL)
+	FUNC0(OP_SLVS,		&solver,		"SLVS",		CNULL)
+	FUNC0(OP_INTI,		&integrate,		"INTI",		CNULL)
+	FUNC0(OP_INTS,		&integrate,		"INTS",		CNULL)
+	FUNC0(OP_SUMS,		&sum_product,		"SUMS",		CNULL)
+	FUNC0(OP_PRDS,		&sum_product,		"PRDS",		CNULL)
+
 #undef FUNC
 #undef FUNC0
 #undef FUNC1
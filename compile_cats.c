@@ -598,6 +598,7 @@ static s_opcode matrix_catalogue[] = {
 #endif
 #ifdef MATRIX_LU_DECOMP
 	MON(OP_MAT_LU,		"M.LU")
+	TRI(OP_MAT_LU_SOLVE,	"LUSOLV")
 #endif
 #ifdef SILLY_MATRIX_SUPPORT
 	NILIC(OP_MAT_ZERO,	"M.ZERO")
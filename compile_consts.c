@@ -32,6 +32,7 @@
 
 #define DECNUMDIGITS	1000
 #define DFLT		39
+#define SINCOS		51		/* SINCOS_DIGITS in decn.c */
 
 #define CONST_NAMELEN		4
 #define METRIC_NAMELEN		2
@@ -122,8 +123,10 @@ static struct {
 	{ DFLT,  "0_1",			"0.1"		},
 	{ DFLT,  "0_0195",		"0.0195"	},
 	{ DFLT,  "0_2",			"0.2"		},
+	{ DFLT,  "0_222",		"0.222"		},
 	{ DFLT,  "0_2214",		"0.2214"	},
 	{ DFLT,  "0_25",		"0.25"		},
+	{ DFLT,  "0_264",		"0.264"		},
 	{ DFLT,  "0_04",		"0.04"		},
 	{ DFLT,  "0_05",		"0.05"		},
 	{ DFLT,  "0_4",			"0.4"		},
@@ -143,6 +146,7 @@ static struct {
 	{ DFLT,  "1_5",			"1.5"		},
 	{ DFLT,  "1_7",			"1.7"		},
 	{ DFLT,  "9on5",		"1.8"		},
+	{ DFLT,  "1_9",			"1.9"		},
 	{ DFLT,  "2_326",		"2.326"		},
 	{ DFLT,  "root2on2",		"0.70710678118654752440084436210484903928483593768847"	},
 	{ DFLT,  "e",			"2.71828182845904523536028747135266249775724709369995"	},
@@ -166,6 +170,7 @@ static struct {
 					      "03741442269999999674595609990211946346563219263719"
 */
 												},
+	{ DFLT,  "sqrtPI",		"1.77245385090551602729816748334114518279754945612239"	},
 	{ DFLT,  "sqrt2PI",		"2.50662827463100050241576528481104525300698674060994"	},
 	{ DFLT,  "recipsqrt2PI",	"0.3989422804014326779399460599343818684758586311649347"	},
 	{ DFLT,  "PIon2",		"1.57079632679489661923132169163975144209858469968755"	},
@@ -173,6 +178,32 @@ static struct {
 	{ DFLT,  "PIon200",		"0.015707963267948966192313216916397514420985846996876" },
 	{ DFLT,  "ln2",			"0.6931471805599453094172321214581765680755001343602553"	},
 	{ DFLT,  "ln10",		"2.30258509299404568401799145468436420760110148862877"	},
+	// Range reduction tables of dn_ln
+	{ DFLT,  "ln3",		"1.0986122886681096913952452369225257046474905578227494"	},
+	{ DFLT,  "ln4",		"1.3862943611198906188344642429163531361510002687205105"	},
+	{ DFLT,  "ln5",		"1.6094379124341003746007593332261876395256013542685177"	},
+	{ DFLT,  "ln6",		"1.7917594692280550008124773583807022727229906921830047"	},
+	{ DFLT,  "ln7",		"1.9459101490553133051053527434431797296370847295818611"	},
+	{ DFLT,  "ln8",		"2.0794415416798359282516963643745297042265004030807657"	},
+	{ DFLT,  "ln9",		"2.1972245773362193827904904738450514092949811156454989"	},
+	{ DFLT,  "ln1_1",		"0.0953101798043248600439521232807650922206053653086441"	},
+	{ DFLT,  "ln1_2",		"0.1823215567939546262117180251545146331973893379144869"	},
+	{ DFLT,  "ln1_3",		"0.2623642644674910520354959868809543972041664561314341"	},
+	{ DFLT,  "ln1_4",		"0.3364722366212129305045934102169920901114833753133434"	},
+	{ DFLT,  "ln1_5",		"0.4054651081081643819780131154643491365719904234624941"	},
+	{ DFLT,  "ln1_6",		"0.4700036292457355536509370311483420647008990488122480"	},
+	{ DFLT,  "ln1_7",		"0.5306282510621703962315431631887623279871015239569718"	},
+	{ DFLT,  "ln1_8",		"0.5877866649021190081897311406188637697693797613769811"	},
+	{ DFLT,  "ln1_9",		"0.6418538861723947759910359772034893296362777726703558"	},
+	{ DFLT,  "ln1_01",		"0.0099503308531680828482153575442607416886796099400587"	},
+	{ DFLT,  "ln1_02",		"0.0198026272961797130260290668851003931089907275112035"	},
+	{ DFLT,  "ln1_03",		"0.0295588022415444027326194056847124054260581311132572"	},
+	{ DFLT,  "ln1_04",		"0.0392207131532812962692008965711198938295653705834269"	},
+	{ DFLT,  "ln1_05",		"0.0487901641694320030653744042231646586079736644155824"	},
+	{ DFLT,  "ln1_06",		"0.0582689081239757755257183511185059232332749100139269"	},
+	{ DFLT,  "ln1_07",		"0.0676586484738148052684159076545485863609432988738616"	},
+	{ DFLT,  "ln1_08",		"0.0769610411361283249842170443152018348912689649312129"	},
+	{ DFLT,  "ln1_09",		"0.0861776962410523323413335428404732358581459062456852"	},
 	{ DFLT,  "phi",			"1.61803398874989484820458683436563811772030917980576" },
 	{ DFLT,  "egamma",		"0.5772156649015328606065120900824024310421593359399235988" },
 	{ DFLT,  "_1onPI",		"-0.31830988618379067153776752674502872406891929148091" },
@@ -181,6 +212,45 @@ static struct {
 	// randfac = 2^-32  This converts a 32 integer into a [0, 1) interval
 	{ DFLT, "randfac",		"0.00000000023283064365386962890625" },
 
+	// Argument reduction table and series coefficients of sincosTaylor
+	{ SINCOS, "PIon2_sincos",	"1.570796326794896619231321691639751442098584699687552910487472"	},
+	{ SINCOS, "sin1_8",		"0.124674733385227689957442708712108467587834905641679257885515"	},
+	{ SINCOS, "cos1_8",		"0.992197667229329053149096907788250869543327304736601263468910"	},
+	{ SINCOS, "sin2_8",		"0.247403959254522929596848704849389195893390980386965810676545"	},
+	{ SINCOS, "cos2_8",		"0.968912421710644784144595449494189199804134190287442831148128"	},
+	{ SINCOS, "sin3_8",		"0.366272529086047561372909351716264157176413014397357902868531"	},
+	{ SINCOS, "cos3_8",		"0.930507621912314291149476792229555508095191001871510011289405"	},
+	{ SINCOS, "sin4_8",		"0.479425538604203000273287935215571388081803367940600675188617"	},
+	{ SINCOS, "cos4_8",		"0.877582561890372716116281582603829651991645197109744052997611"	},
+	{ SINCOS, "sin5_8",		"0.585097272940462154805399314150080440689462340996045214544863"	},
+	{ SINCOS, "cos5_8",		"0.810963119505217902189534803941080735400176151896869577928360"	},
+	{ SINCOS, "sin6_8",		"0.681638760023334166733241952779893935338382394659229909213625"	},
+	{ SINCOS, "cos6_8",		"0.731688868873820886311838753000084543840541276050772482507683"	},
+	{ SINCOS, "invfact2",	"5E-1"	},
+	{ SINCOS, "invfact3",	"1.66666666666666666666666666666666666666666666666666666666667E-1"	},
+	{ SINCOS, "invfact4",	"4.16666666666666666666666666666666666666666666666666666666667E-2"	},
+	{ SINCOS, "invfact5",	"8.33333333333333333333333333333333333333333333333333333333333E-3"	},
+	{ SINCOS, "invfact6",	"1.38888888888888888888888888888888888888888888888888888888889E-3"	},
+	{ SINCOS, "invfact7",	"1.98412698412698412698412698412698412698412698412698412698413E-4"	},
+	{ SINCOS, "invfact8",	"2.48015873015873015873015873015873015873015873015873015873016E-5"	},
+	{ SINCOS, "invfact9",	"2.75573192239858906525573192239858906525573192239858906525573E-6"	},
+	{ SINCOS, "invfact10",	"2.75573192239858906525573192239858906525573192239858906525573E-7"	},
+	{ SINCOS, "invfact11",	"2.50521083854417187750521083854417187750521083854417187750521E-8"	},
+	{ SINCOS, "invfact12",	"2.08767569878680989792100903212014323125434236545347656458768E-9"	},
+	{ SINCOS, "invfact13",	"1.60590438368216145993923771701549479327257105034882812660590E-10"	},
+	{ SINCOS, "invfact14",	"1.14707455977297247138516979786821056662326503596344866186136E-11"	},
+	{ SINCOS, "invfact15",	"7.64716373181981647590113198578807044415510023975632441240907E-13"	},
+	{ SINCOS, "invfact16",	"4.77947733238738529743820749111754402759693764984770275775567E-14"	},
+	{ SINCOS, "invfact17",	"2.81145725434552076319894558301032001623349273520453103397392E-15"	},
+	{ SINCOS, "invfact18",	"1.56192069685862264622163643500573334235194040844696168554107E-16"	},
+	{ SINCOS, "invfact19",	"8.22063524662432971695598123687228074922073899182611413442667E-18"	},
+	{ SINCOS, "invfact20",	"4.11031762331216485847799061843614037461036949591305706721334E-19"	},
+	{ SINCOS, "invfact21",	"1.95729410633912612308475743735054303552874737900621765105397E-20"	},
+	{ SINCOS, "invfact22",	"8.89679139245057328674889744250246834331248808639189841388168E-22"	},
+	{ SINCOS, "invfact23",	"3.86817017063068403771691193152281232317934264625734713647030E-23"	},
+	{ SINCOS, "invfact24",	"1.61173757109611834904871330480117180132472610260722797352929E-24"	},
+	{ SINCOS, "invfact25",	"6.44695028438447339619485321920468720529890441042891189411716E-26"	},
+
 	// Gamma estimate constants
 	{ DFLT, "gammaR",		"23.118910" },
 	{ DFLT, "gammaC00",		"2.5066282746310005024157652848102462181924349228522"},
@@ -206,6 +276,23 @@ static struct {
 	{ DFLT, "gammaC20",		"-.00000079888858662627061894258490790700823308816322084001"},
 	{ DFLT, "gammaC21",		".000000000016573444251958462210600022758402017645596303687465"},
 
+	// Factorials of every 16th integer for the fast path of the gamma function
+	{ DFLT, "fact16",		"20922789888000" },
+	{ DFLT, "fact32",		"263130836933693530167218012160000000" },
+	{ DFLT, "fact48",		"1.24139155925360726708622890473733750385214864E+61" },
+	{ DFLT, "fact64",		"1.26886932185884164103433389335161480802865516E+89" },
+	{ DFLT, "fact80",		"7.15694570462638022948115337231865321655846573E+118" },
+	{ DFLT, "fact96",		"9.91677934870949689209571401541893801158183649E+149" },
+	{ DFLT, "fact112",		"1.97450685722107402353682037275992488341277868E+182" },
+	{ DFLT, "fact128",		"3.85620482362580421735677065923463640617493110E+215" },
+	{ DFLT, "fact144",		"5.55029383273930478955105466055038811799998234E+249" },
+	{ DFLT, "fact160",		"4.71472363599206132240694321176194377951192623E+284" },
+	{ DFLT, "fact176",		"1.97903110431089593781523349201027948917123036E+320" },
+	{ DFLT, "fact192",		"3.54996793146960497053355363383973425965094810E+356" },
+	{ DFLT, "fact208",		"2.41111005450527600328717895291292670443358181E+393" },
+	{ DFLT, "fact224",		"5.59715935375377604046045731013645931764994049E+430" },
+	{ DFLT, "fact240",		"4.06788536364705812049357592148688531017205126E+468" },
+
 	{ -1,  NULL,	  NULL		  }
 };
 
@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <string.h>
+#include <setjmp.h>
+#include <time.h>
 
 #include "xeq.h" 
 #include "keys.h"
@@ -32,6 +34,10 @@
 
 #include "catalogues.h"
 
+#ifdef INCLUDE_MULTI_INSTANCE
+#include <pthread.h>
+#endif
+
 
 #define CH_QUIT		'Q'
 #define CH_TRACE	'T'
@@ -40,9 +46,12 @@
 #define CH_REFRESH	12	/* ^L */
 #define CH_COPY		'X'
 #define CH_PASTE	'V'
+#define CH_PROFILE	'P'
 
-unsigned long long int instruction_count = 0;
-int view_instruction_counter = 0;
+PER_INSTANCE unsigned long long int instruction_count = 0;
+PER_INSTANCE int view_instruction_counter = 0;
+PER_INSTANCE int batch_mode = 0;
+PER_INSTANCE unsigned int batch_error = ERR_NONE;
 
 /*
  *  PC keys to calculator keys
@@ -478,8 +487,705 @@ static unsigned int dump_commands(int silent) {
 }
 
 
+#ifdef INCLUDE_PROFILER
+/*
+ *  Profiler: every program step executed, user code and XROM alike, is
+ *  counted and timed.  A shadow call stack follows XEQ, the calls into and
+ *  out of XROM and the returns so the time can be booked on call chains, too.
+ *  The report lists the busiest steps, opcodes and routines, the folded
+ *  stacks are the input format of flamegraph.pl and similar tools.
+ *
+ *  profile <state file> [<label> | @<key file> | -] works like batch mode
+ *  and writes both files at the end, in the interactive emulator the P key
+ *  starts profiling and writes them when pressed again or on exit.
+ */
+#define PROFILE_FILE	"wp34s.prof"
+#define FOLDED_FILE	"wp34s.folded"
+#define PROFILE_DEPTH	32		// Deepest call chain tracked
+#define PROFILE_NEST	8		// Steps run from within a step
+#define PROFILE_CHAINS	4096		// Distinct call chains, a power of two
+#define PROFILE_TOP	40		// Lines in the step listing
+#define PROFILE_SIZE	(LIB_ADDR_MASK + 1)
+#define NARROW_SPACE	'\006'
+
+PER_INSTANCE int profiling;
+
+static PER_INSTANCE struct _profile {
+	struct _profile_step {
+		unsigned long long count, ns;
+		opcode op;
+	} step[REGION_XROM + 1][PROFILE_SIZE];
+	struct _profile_chain {
+		unsigned long long count, ns;
+		unsigned int depth;
+		unsigned int entry[PROFILE_DEPTH];
+	} chain[PROFILE_CHAINS];
+	struct {
+		unsigned int entry;	// first step executed in the routine
+		unsigned int ret;	// return address into the caller
+	} frame[PROFILE_DEPTH];
+	unsigned int depth;		// frames on the shadow stack, 0 if not running
+	int current;			// chain of the shadow stack, -1 if full, -2 if unknown
+	unsigned int last_ret;		// address following the previous step
+	opcode last_op;
+	int nest;
+	struct {
+		unsigned long long start, child;
+		unsigned int pc;
+		int chain;
+	} active[PROFILE_NEST];
+} *Profile;
+
+static unsigned long long profile_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int profile_is_call(const opcode op) {
+	if (isDBL(op))
+		return opDBL(op) == DBL_XEQ;
+	if (isRARG(op))
+		switch (RARG_CMD(op)) {
+		case RARG_XEQ:	case RARG_BSF:	case RARG_BSB:
+#ifdef INCLUDE_INDIRECT_BRANCHES
+		case RARG_iBSF:	case RARG_iBSB:
+#endif
+			return 1;
+		default:
+			return 0;
+		}
+	return op == (OP_NIL | OP_XEQALPHA) || op == (OP_NIL | OP_GSBuser);
+}
+
+static int profile_is_label(const opcode op) {
+	if (isDBL(op))
+		return opDBL(op) == DBL_LBL;
+	return isRARG(op) && RARG_CMD(op) == RARG_LBL;
+}
+
+/*
+ *  Find or add the chain matching the shadow stack
+ */
+static int profile_chain(struct _profile *p) {
+	unsigned int h = p->depth, i, n;
+
+	for (i = 0; i < p->depth; i++)
+		h = h * 31 + p->frame[i].entry;
+	for (n = 0; n < PROFILE_CHAINS; n++) {
+		const int k = (h + n) & (PROFILE_CHAINS - 1);
+		struct _profile_chain *const c = p->chain + k;
+
+		if (c->depth == 0) {
+			c->depth = p->depth;
+			for (i = 0; i < p->depth; i++)
+				c->entry[i] = p->frame[i].entry;
+			return k;
+		}
+		if (c->depth == p->depth) {
+			for (i = 0; i < p->depth && c->entry[i] == p->frame[i].entry; i++)
+				;
+			if (i == p->depth)
+				return k;
+		}
+	}
+	return -1;	// The time still shows up in the step and routine lists
+}
+
+void profile_enter(unsigned int pc, opcode op) {
+	struct _profile *const p = Profile;
+
+	if (p->depth == 0) {
+		// Start of a run
+		p->frame[0].entry = pc;
+		p->frame[0].ret = 0;
+		p->depth = 1;
+		p->current = -2;
+	}
+	else if (pc != p->last_ret) {
+		// Branch, return or call
+		unsigned int i;
+
+		for (i = p->depth - 1; i > 0 && p->frame[i].ret != pc; i--)
+			;
+		if (i > 0) {
+			p->depth = i;
+			p->current = -2;
+		}
+		else if ((profile_is_call(p->last_op) || nLIB(pc) != nLIB(p->last_ret)) && p->depth < PROFILE_DEPTH) {
+			p->frame[p->depth].entry = pc;
+			p->frame[p->depth].ret = p->last_ret;
+			p->depth++;
+			p->current = -2;
+		}
+	}
+	if (p->current == -2)
+		p->current = profile_chain(p);
+
+	p->step[nLIB(pc)][pc & LIB_ADDR_MASK].op = op;
+	if (p->nest < PROFILE_NEST) {
+		p->active[p->nest].pc = pc;
+		p->active[p->nest].chain = p->current;
+		p->active[p->nest].child = 0;
+		p->active[p->nest].start = profile_now();
+	}
+	p->nest++;
+	p->last_ret = state_pc();
+	p->last_op = op;
+}
+
+void profile_leave(void) {
+	struct _profile *const p = Profile;
+
+	if (--p->nest < PROFILE_NEST) {
+		const unsigned long long elapsed = profile_now() - p->active[p->nest].start;
+		const unsigned long long self = elapsed - p->active[p->nest].child;
+		const unsigned int pc = p->active[p->nest].pc;
+		struct _profile_step *const s = &p->step[nLIB(pc)][pc & LIB_ADDR_MASK];
+
+		s->count++;
+		s->ns += self;
+		if (p->active[p->nest].chain >= 0) {
+			p->chain[p->active[p->nest].chain].count++;
+			p->chain[p->active[p->nest].chain].ns += self;
+		}
+		if (p->nest > 0)
+			p->active[p->nest - 1].child += elapsed;
+	}
+	if (! Running && ! XromRunning)
+		p->depth = 0;
+}
+
+/*
+ *  Map every step to the routine it belongs to, this is the closest label
+ *  or XROM entry point before it or the start of its program.
+ */
+static unsigned int (*profile_owners(void))[PROFILE_SIZE] {
+	unsigned int (*owner)[PROFILE_SIZE] = calloc(REGION_XROM + 1, sizeof(*owner));
+	int r, i;
+
+	if (owner == NULL)
+		return NULL;
+	for (r = 0; r <= REGION_XROM; r++) {
+		const unsigned int end = addrLIB(sizeLIB(r) + 1, r);
+		unsigned int pc = addrLIB(1, r), entry = pc;
+
+		while (pc < end) {
+			const opcode op = getprog(pc);
+
+			if (r == REGION_XROM) {
+				for (i = 0; i < num_xrom_entry_points; i++)
+					if (addrXROM(xrom_entry_points[i].address) == pc)
+						entry = pc;
+			}
+			else if (profile_is_label(op))
+				entry = pc;
+			owner[r][pc & LIB_ADDR_MASK] = entry;
+			pc += isDBL(op) ? 2 : 1;
+			if (op == (OP_NIL | OP_END))
+				entry = pc;
+		}
+	}
+	return owner;
+}
+
+/*
+ *  Copy text with the special characters spelled out, the folded stack
+ *  format needs names without blanks and semicolons.  Two narrow spaces
+ *  make up a blank as in the program listings.
+ */
+static char *profile_text(char *q, const char *p) {
+	for (; *p != '\0'; p++) {
+		const char *m = pretty(*p);
+
+		if (*p == NARROW_SPACE && p[1] == NARROW_SPACE)
+			continue;
+		if (*p == ' ' || *p == NARROW_SPACE)
+			*q++ = '_';
+		else if (m != NULL)
+			q += sprintf(q, "[%s]", m);
+		else
+			*q++ = *p == ';' ? ',' : *p;
+	}
+	*q = '\0';
+	return q;
+}
+
+/*
+ *  Printable name of a routine
+ */
+static const char *profile_name(char *buf, unsigned int (*owner)[PROFILE_SIZE], unsigned int entry) {
+	static const char *const prefix[] = { "", "LIB:", "BUP:", "XROM:" };
+	const int r = nLIB(entry);
+	const unsigned int start = owner[r][entry & LIB_ADDR_MASK];
+	char instr[16], *q = buf;
+	const char *p = NULL;
+	int i;
+
+	q += sprintf(q, "%s", prefix[r]);
+	if (r == REGION_XROM) {
+		for (i = 0; i < num_xrom_entry_points; i++)
+			if (addrXROM(xrom_entry_points[i].address) == start)
+				p = xrom_entry_points[i].name;
+	}
+	else if (start != 0 && profile_is_label(getprog(start))) {
+		p = prt(getprog(start), instr) + 3;	// Skip LBL
+		while (*p == ' ' || *p == NARROW_SPACE)
+			p++;
+	}
+	if (p == NULL)
+		q += sprintf(q, "%04x", start);
+	else
+		q = profile_text(q, p);
+	if (entry != start)
+		sprintf(q, "+%u", entry - start);
+	return buf;
+}
+
+struct _profile_total {
+	const char *name;
+	unsigned int entry;
+	unsigned long long count, ns, incl;
+};
+
+static int profile_by_time(const void *a, const void *b) {
+	const unsigned long long x = ((const struct _profile_total *) a)->ns;
+	const unsigned long long y = ((const struct _profile_total *) b)->ns;
+
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+static struct _profile_total *profile_find(struct _profile_total *t, int *n, const char *name, unsigned int entry) {
+	int i;
+
+	for (i = 0; i < *n; i++)
+		if (name != NULL ? strcmp(t[i].name, name) == 0 : t[i].entry == entry)
+			return t + i;
+	t[*n].name = name;
+	t[*n].entry = entry;
+	return t + (*n)++;
+}
+
+static void profile_report(void) {
+	struct _profile *const p = Profile;
+	unsigned int (*const owner)[PROFILE_SIZE] = profile_owners();
+	const int max = (REGION_XROM + 1) * PROFILE_SIZE;
+	struct _profile_total *steps = calloc(max, sizeof(*steps));
+	struct _profile_total *ops = calloc(max, sizeof(*ops));
+	struct _profile_total *routines = calloc(max, sizeof(*routines));
+	char (*names)[64] = calloc(max, sizeof(*names));
+	unsigned long long count = 0, ns = 0;
+	int nsteps = 0, nops = 0, nroutines = 0, r, i, j;
+	char buf[128], instr[16];
+	FILE *f;
+
+	if (owner == NULL || steps == NULL || ops == NULL || routines == NULL || names == NULL) {
+		fprintf(stderr, "out of memory for the profile\n");
+		goto done;
+	}
+	for (r = 0; r <= REGION_XROM; r++)
+		for (i = 0; i < PROFILE_SIZE; i++) {
+			const struct _profile_step *const s = &p->step[r][i];
+			const unsigned int pc = addrLIB(i, r);
+			struct _profile_total *t;
+			char *q;
+
+			if (s->count == 0)
+				continue;
+			count += s->count;
+			ns += s->ns;
+			t = steps + nsteps++;
+			t->entry = pc;
+			t->count = s->count;
+			t->ns = s->ns;
+
+			// Opcodes are grouped without their arguments
+			q = names[nsteps - 1];
+			strcpy(buf, prt(s->op, instr));
+			buf[strcspn(buf, " '\006")] = '\0';
+			profile_text(q, buf);
+			t = profile_find(ops, &nops, q, 0);
+			t->count += s->count;
+			t->ns += s->ns;
+		}
+
+	/*
+	 *  Routines are taken from the call chains: the innermost one gets the
+	 *  time of the chain, every routine in the chain counts it once for its
+	 *  total.
+	 */
+	for (i = 0; i < PROFILE_CHAINS; i++) {
+		const struct _profile_chain *const c = p->chain + i;
+		struct _profile_total *t;
+
+		if (c->depth == 0)
+			continue;
+		t = profile_find(routines, &nroutines, NULL, owner[nLIB(c->entry[c->depth - 1])][c->entry[c->depth - 1] & LIB_ADDR_MASK]);
+		t->count += c->count;
+		t->ns += c->ns;
+		for (j = 0; j < (int) c->depth; j++) {
+			const unsigned int o = owner[nLIB(c->entry[j])][c->entry[j] & LIB_ADDR_MASK];
+			int k;
+
+			for (k = 0; k < j && owner[nLIB(c->entry[k])][c->entry[k] & LIB_ADDR_MASK] != o; k++)
+				;
+			if (k == j)
+				profile_find(routines, &nroutines, NULL, o)->incl += c->ns;
+		}
+	}
+
+	qsort(steps, nsteps, sizeof(*steps), profile_by_time);
+	qsort(ops, nops, sizeof(*ops), profile_by_time);
+	qsort(routines, nroutines, sizeof(*routines), profile_by_time);
+	if (ns == 0)
+		ns = 1;
+
+	f = fopen(PROFILE_FILE, "w");
+	if (f == NULL)
+		fprintf(stderr, "cannot write %s\n", PROFILE_FILE);
+	else {
+		fprintf(f, "%llu steps in %.3f ms\n\n", count, ns / 1e6);
+		fprintf(f, "Steps\nADDR          COUNT     SELF ms      %%  ROUTINE / INSTRUCTION\n");
+		for (i = 0; i < nsteps && i < PROFILE_TOP; i++) {
+			const unsigned int pc = steps[i].entry;
+			char text[64];
+
+			profile_text(text, prt(p->step[nLIB(pc)][pc & LIB_ADDR_MASK].op, instr));
+			fprintf(f, "%04x %14llu %11.3f %6.2f  %s / %s\n", pc, steps[i].count, steps[i].ns / 1e6,
+				100.0 * steps[i].ns / ns, profile_name(buf, owner, pc), text);
+		}
+		fprintf(f, "\nOpcodes\n        COUNT     SELF ms      %%  OPCODE\n");
+		for (i = 0; i < nops; i++)
+			fprintf(f, "%14llu %11.3f %6.2f  %s\n", ops[i].count, ops[i].ns / 1e6,
+				100.0 * ops[i].ns / ns, ops[i].name);
+		fprintf(f, "\nRoutines\n        COUNT     SELF ms      %%     TOTAL ms  ROUTINE\n");
+		for (i = 0; i < nroutines; i++)
+			fprintf(f, "%14llu %11.3f %6.2f %12.3f  %s\n", routines[i].count, routines[i].ns / 1e6,
+				100.0 * routines[i].ns / ns, routines[i].incl / 1e6,
+				profile_name(buf, owner, routines[i].entry));
+		fclose(f);
+	}
+
+	f = fopen(FOLDED_FILE, "w");
+	if (f == NULL)
+		fprintf(stderr, "cannot write %s\n", FOLDED_FILE);
+	else {
+		for (i = 0; i < PROFILE_CHAINS; i++) {
+			const struct _profile_chain *const c = p->chain + i;
+
+			if (c->count == 0)
+				continue;
+			for (j = 0; j < (int) c->depth; j++)
+				fprintf(f, "%s%s", j ? ";" : "", profile_name(buf, owner, c->entry[j]));
+			fprintf(f, " %llu\n", c->ns);
+		}
+		fclose(f);
+	}
+done:
+	free(names);
+	free(routines);
+	free(ops);
+	free(steps);
+	free(owner);
+}
+
+/*
+ *  Start collecting or write the reports and stop
+ */
+static void profile_start(void) {
+	if (Profile == NULL)
+		Profile = calloc(1, sizeof(*Profile));
+	profiling = Profile != NULL;
+}
+
+static void profile_stop(void) {
+	profiling = 0;
+	if (Profile != NULL) {
+		profile_report();
+		free(Profile);
+		Profile = NULL;
+	}
+}
+#endif
+
+
+/*
+ *  Batch mode: batch <state file> [<label> | @<key file> | -]
+ *  Loads the state file ("-" starts with cleared memory), executes the label
+ *  or feeds the keys from the file or stdin without using the terminal and
+ *  prints the results one name=value pair per line.  The state file is not
+ *  written back.
+ */
+static PER_INSTANCE jmp_buf *batch_off;	// OFF during a batch run returns here
+
+static void batch_reg(FILE *out, const char *name, int index) {
+	char buf[64];
+
+	if (is_intmode())
+		sprintf(buf, "%llx", (unsigned long long int) get_reg_n_int(index));
+	else if (is_dblmode())
+		decimal128ToString(&(get_reg_n(index)->d), buf);
+	else
+		decimal64ToString(&(get_reg_n(index)->s), buf);
+	fprintf(out, "%s=%s\n", name, buf);
+}
+
+static void batch_results(FILE *out) {
+	const char *p;
+	char name[12];
+	unsigned int i;
+
+	fprintf(out, "error=%u\n", batch_error);
+	fprintf(out, "mode=%s\n", is_intmode() ? "integer" : is_dblmode() ? "double" : "real");
+	fprintf(out, "steps=%llu\n", instruction_count);
+	for (i = 0; REGNAMES[i] != '\0'; i++) {
+		name[0] = REGNAMES[i];
+		name[1] = '\0';
+		batch_reg(out, name, regX_idx + i);
+	}
+	for (i = 0; i < global_regs(); i++) {
+		snprintf(name, sizeof(name), "%02u", i);
+		batch_reg(out, name, i);
+	}
+	fprintf(out, "alpha=");
+	for (p = Alpha; *p != '\0'; p++) {
+		const char *m = pretty(*p);
+		if (m == NULL)
+			putc(*p, out);
+		else
+			fprintf(out, "[%s]", m);
+	}
+	putc('\n', out);
+}
+
+/*
+ *  XEQ a label: A to D, 00 to 99 or an alpha label of up to three characters
+ *  Returns zero if the label can't be parsed
+ */
+static opcode batch_label(const char *target) {
+	const size_t len = strlen(target);
+
+	if (len == 1 && target[0] >= 'A' && target[0] <= 'D')
+		return RARG(RARG_XEQ, 100 + target[0] - 'A');
+	if (len > 0 && len <= 2 && isdigit(target[0]) && isdigit(target[len - 1]))
+		return RARG(RARG_XEQ, atoi(target));
+	if (len > 0 && len <= 3)
+		return OP_DBL + (DBL_XEQ << DBL_SHIFT) + (unsigned char) target[0]
+		     + ((unsigned char) target[1] << 16)
+		     + (len > 2 ? (unsigned char) target[2] << 24 : 0);
+	return 0;
+}
+
+/*
+ *  Key script, characters map to keys as in the interactive mode
+ */
+static void batch_keys(FILE *f) {
+	int c;
+
+	while ((c = getc(f)) != EOF) {
+		c = remap(c);
+		if (c != K_UNKNOWN) {
+			process_keycode(c);
+			process_keycode(K_RELEASE);
+		}
+	}
+}
+
+/*
+ *  Calculator instances for batch runs.  All emulator state is per instance
+ *  which means per thread, so a thread hosts at most one instance at a time.
+ *  instance_open() sets up the calculator of the calling thread from a state
+ *  file, instance_run() executes a target as in batch mode and writes the
+ *  results to out and instance_close() gives up the instance again.
+ */
+int instance_open(const char *state) {
+	batch_mode = 1;
+	batch_error = ERR_NONE;
+	instruction_count = 0;
+	xeq_init_contexts();
+	if (strcmp(state, "-") == 0) {
+		load_statefile(NULL);
+		reset();
+	}
+	else {
+		FILE *f = fopen(state, "rb");
+		if (f == NULL) {
+			fprintf(stderr, "cannot open state file %s\n", state);
+			return 1;
+		}
+		fclose(f);
+		load_statefile(state);
+	}
+	init_34s();
+	return 0;
+}
+
+int instance_run(const char *target, FILE *out) {
+	FILE *keys = NULL;
+	opcode op = 0;
+	jmp_buf off;
+
+	if (*target == '@') {
+		keys = fopen(target + 1, "r");
+		if (keys == NULL) {
+			fprintf(stderr, "cannot open key script %s\n", target + 1);
+			return 1;
+		}
+	}
+	else if (strcmp(target, "-") == 0)
+		keys = stdin;
+	else if ((op = batch_label(target)) == 0) {
+		fprintf(stderr, "bad label %s\n", target);
+		return 1;
+	}
+
+	if (setjmp(off) == 0) {
+		batch_off = &off;
+		if (keys != NULL)
+			batch_keys(keys);
+		else {
+			xeq(op);
+			if (Running || Pause)
+				xeqprog();
+		}
+	}
+	batch_off = NULL;
+	if (keys != NULL && keys != stdin)
+		fclose(keys);
+	batch_results(out);
+	return 0;
+}
+
+void instance_close(void) {
+	Running = XromRunning = 0;
+	Pause = 0;
+	invalidate_program_index(-1);
+	batch_mode = 0;
+}
+
+static int batch(const char *state, const char *target) {
+	const int r = instance_open(state) || instance_run(target, stdout);
+
+	instance_close();
+	return r;
+}
+
+
+#ifdef INCLUDE_MULTI_INSTANCE
+/*
+ *  Parallel batch mode: parallel <threads> <job file>
+ *  Every line of the job file holds a state file and a label or @<key file>
+ *  as for batch mode.  A pool of threads runs the jobs, each on its own calculator, and
+ *  the results are printed in the order of the job file.  The calculators
+ *  read the library and backup files but keep what they write to flash to
+ *  themselves, so jobs cannot race on the files or see each other's data.
+ */
+#define WORKER_STACK (16 * 1024 * 1024)	// The per thread state lives here too
+
+static struct _batch_job {
+	char state[FILENAME_MAX + 1];
+	char target[FILENAME_MAX + 1];
+	char *output;
+	size_t size;
+	int status;
+} *Jobs;
+static int JobCount, NextJob;
+static pthread_mutex_t JobLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *batch_worker(void *arg) {
+	for (;;) {
+		struct _batch_job *job;
+		FILE *out;
+
+		pthread_mutex_lock(&JobLock);
+		job = NextJob < JobCount ? Jobs + NextJob++ : NULL;
+		pthread_mutex_unlock(&JobLock);
+		if (job == NULL)
+			break;
+
+		PrivateFlash = 1;
+		out = open_memstream(&job->output, &job->size);
+		if (out == NULL)
+			job->status = 1;
+		else {
+			job->status = instance_open(job->state) || instance_run(job->target, out);
+			fclose(out);
+		}
+		instance_close();
+	}
+	return NULL;
+}
+
+static int parallel(int threads, const char *jobfile) {
+	char line[1024];
+	pthread_t *pool;
+	pthread_attr_t attr;
+	FILE *f = strcmp(jobfile, "-") == 0 ? stdin : fopen(jobfile, "r");
+	int i, n, r = 0;
+
+	if (f == NULL) {
+		fprintf(stderr, "cannot open job file %s\n", jobfile);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		char state[FILENAME_MAX + 1], target[FILENAME_MAX + 1];
+
+		if (sscanf(line, "%s %s", state, target) != 2 || *state == '#')
+			continue;
+		if ((JobCount & 63) == 0)
+			Jobs = realloc(Jobs, (JobCount + 64) * sizeof(*Jobs));
+		memset(Jobs + JobCount, 0, sizeof(*Jobs));
+		strcpy(Jobs[JobCount].state, state);
+		strcpy(Jobs[JobCount].target, target);
+		JobCount++;
+	}
+	if (f != stdin)
+		fclose(f);
+
+	if (threads < 1)
+		threads = 1;
+	if (threads > JobCount)
+		threads = JobCount;
+	pool = calloc(threads, sizeof(pthread_t));
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, WORKER_STACK);
+	for (n = 0; n < threads; n++)
+		if (pthread_create(pool + n, &attr, batch_worker, NULL) != 0)
+			break;
+	pthread_attr_destroy(&attr);
+	if (n == 0 && JobCount > 0) {
+		fprintf(stderr, "cannot create worker threads\n");
+		return 1;
+	}
+	for (i = 0; i < n; i++)
+		pthread_join(pool[i], NULL);
+	free(pool);
+
+	for (i = 0; i < JobCount; i++) {
+		printf("job=%d\n", i + 1);
+		if (Jobs[i].output != NULL)
+			fwrite(Jobs[i].output, 1, Jobs[i].size, stdout);
+		free(Jobs[i].output);
+		r |= Jobs[i].status;
+	}
+	free(Jobs);
+	return r;
+}
+#endif
+
+
 void shutdown( void )
 {
+#ifdef INCLUDE_PROFILER
+	profile_stop();
+#endif
+	if ( batch_mode ) {
+		// OFF in a batch run, leave the state file alone
+		if ( batch_off != NULL )
+			longjmp( *batch_off, 1 );
+		exit( 0 );
+	}
 	checksum_all();
 	setuptty( 1 );
 	save_statefile( NULL );
@@ -557,6 +1263,46 @@ int main(int argc, char *argv[]) {
 
 	xeq_init_contexts();
 	load_statefile( NULL );
+	if (argc > 2 && strcmp(argv[1], "batch") == 0)
+		return batch(argv[2], argc > 3 ? argv[3] : "-");
+#ifdef INCLUDE_BENCHMARKS
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		extern int bench(int argc, char *argv[]);
+		return bench(argc - 2, argv + 2);
+	}
+	if (argc > 1 && strcmp(argv[1], "xbench") == 0) {
+		extern int xbench(int argc, char *argv[]);
+		return xbench(argc - 2, argv + 2);
+	}
+	if (argc > 1 && strcmp(argv[1], "sincos") == 0) {
+		extern int sincos_check(int argc, char *argv[]);
+		return sincos_check(argc - 2, argv + 2);
+	}
+#ifdef INCLUDE_NATIVE_DISTRIBUTIONS
+	if (argc > 1 && strcmp(argv[1], "dist") == 0) {
+		extern int dist_check(int argc, char *argv[]);
+		return dist_check(argc - 2, argv + 2);
+	}
+#endif
+#ifdef INCLUDE_FACTOR
+	if (argc > 1 && strcmp(argv[1], "factor") == 0) {
+		extern int factor_check(int argc, char *argv[]);
+		return factor_check(argc - 2, argv + 2);
+	}
+#endif
+#endif
+#ifdef INCLUDE_PROFILER
+	if (argc > 2 && strcmp(argv[1], "profile") == 0) {
+		profile_start();
+		n = batch(argv[2], argc > 3 ? argv[3] : "-");
+		profile_stop();
+		return n;
+	}
+#endif
+#ifdef INCLUDE_MULTI_INSTANCE
+	if (argc > 3 && strcmp(argv[1], "parallel") == 0)
+		return parallel(atoi(argv[2]), argv[3]);
+#endif
 	if (argc > 1) {
 		if (argc == 2) {
 			if (strcmp(argv[1], "commands") == 0) {
@@ -678,6 +1424,14 @@ skipargs:
 				instruction_count = 0;
 				view_instruction_counter = 1 - view_instruction_counter;
 				display();
+#ifdef INCLUDE_PROFILER
+			} else if (c == CH_PROFILE) {
+				// Toggling off writes the report
+				if (profiling)
+					profile_stop();
+				else
+					profile_start();
+#endif
 			} else if (c == CH_PASTE) {
 				paste_raw_x("123.14159265358979323846264338327950\n"
 						"9.876543210987654321e123;"
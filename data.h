@@ -211,7 +211,7 @@ typedef struct _ram {
 
 } TPersistentRam;
 
-extern TPersistentRam PersistentRam;
+extern PER_INSTANCE TPersistentRam PersistentRam;
 
 #define State		(PersistentRam._state)
 #define UState		(PersistentRam._ustate)
@@ -327,7 +327,7 @@ typedef struct _while_on {
 
 } TStateWhileOn;
 
-extern TStateWhileOn StateWhileOn;
+extern PER_INSTANCE TStateWhileOn StateWhileOn;
 
 #define State2		 (StateWhileOn._state2)
 #define TestFlag	 (State2.test_flag)
@@ -385,7 +385,7 @@ typedef struct _xrom_params
 	signed short int user_ret_stk_ptr;      // ... the user stack pointer
 } TXromParams;
 
-extern TXromParams XromParams;
+extern PER_INSTANCE TXromParams XromParams;
 
 #define XROM_SYSTEM_FLAG_BASE (8)
 
@@ -401,7 +401,7 @@ extern TXromParams XromParams;
 
 /* Private memory for storing registers A-D
  */
-extern REGISTER XromA2D[4];
+extern PER_INSTANCE REGISTER XromA2D[4];
 
 
 /*
@@ -419,7 +419,7 @@ typedef struct _xrom_local
 
 } TXromLocal;
 
-extern TXromLocal XromLocal;
+extern PER_INSTANCE TXromLocal XromLocal;
 
 #define XromStack  (XromLocal._stack)
 #define XromRetStk (XromLocal._ret_stk + XROM_RET_STACK_SIZE)
@@ -458,41 +458,46 @@ extern FLAG Xtal;
 
 extern volatile FLAG WaitForLcd;     // Sync with display refresh
 extern FLAG DebugFlag;		     // Set in Main
-extern volatile unsigned char Pause; // Count down for programmed pause
-extern FLAG Running, XromRunning;    // Program is active
+extern PER_INSTANCE volatile unsigned char Pause; // Count down for programmed pause
+extern PER_INSTANCE FLAG Running, XromRunning;    // Program is active
 extern FLAG JustStopped;             // Set on program stop to ignore the next R/S key in the buffer
-extern SMALL_INT Error;	     	     // Did an error occur, if so what code?
-extern SMALL_INT ShowRegister;       // Temporary display (not X)
-extern FLAG PcWrapped;		     // decpc() or incpc() have wrapped around
-extern FLAG ShowRPN;		     // controls the RPN annunciator
-extern FLAG IoAnnunciator;	     // Indicates I/O in progress (higher power consumption)
-extern SMALL_INT IntMaxWindow;       // Number of windows for integer display
-extern const char *DispMsg;	     // What to display in message area
-extern short int DispPlot;	     // Which register to base graphical display from
-extern unsigned int OpCode;          // Pending execution waiting for key-release
-extern s_opcode XeqOpCode;	     // Currently executed function
-extern FLAG GoFast;	 	     // Speed-up might be necessary
-extern unsigned short *RetStk;	     // Pointer to current top of return stack
-extern SMALL_INT RetStkSize;         // actual size of return stack
-extern SMALL_INT ProgFree;	     // Remaining program steps
-extern SMALL_INT SizeStatRegs;       // Size of summation register block
-extern REGISTER *StackBase;	     // Location of the RPN stack
-extern decContext Ctx;		     // decNumber library context
-extern FLAG JustDisplayed;	     // Avoid duplicate calls to display();
-extern FLAG WasDataEntry;	     // No need to update the display
-extern char TraceBuffer[];           // Display current instruction
+extern PER_INSTANCE SMALL_INT Error;	     	     // Did an error occur, if so what code?
+extern PER_INSTANCE SMALL_INT ShowRegister;       // Temporary display (not X)
+extern PER_INSTANCE FLAG PcWrapped;		     // decpc() or incpc() have wrapped around
+extern PER_INSTANCE FLAG ShowRPN;		     // controls the RPN annunciator
+extern PER_INSTANCE FLAG IoAnnunciator;	     // Indicates I/O in progress (higher power consumption)
+extern PER_INSTANCE SMALL_INT IntMaxWindow;       // Number of windows for integer display
+extern PER_INSTANCE const char *DispMsg;	     // What to display in message area
+extern PER_INSTANCE short int DispPlot;	     // Which register to base graphical display from
+extern PER_INSTANCE unsigned int OpCode;          // Pending execution waiting for key-release
+extern PER_INSTANCE s_opcode XeqOpCode;	     // Currently executed function
+extern PER_INSTANCE FLAG GoFast;	 	     // Speed-up might be necessary
+extern PER_INSTANCE unsigned short *RetStk;	     // Pointer to current top of return stack
+extern PER_INSTANCE SMALL_INT RetStkSize;         // actual size of return stack
+extern PER_INSTANCE SMALL_INT ProgFree;	     // Remaining program steps
+extern PER_INSTANCE SMALL_INT SizeStatRegs;       // Size of summation register block
+extern PER_INSTANCE REGISTER *StackBase;	     // Location of the RPN stack
+extern PER_INSTANCE decContext Ctx;		     // decNumber library context
+extern PER_INSTANCE FLAG JustDisplayed;	     // Avoid duplicate calls to display();
+extern PER_INSTANCE FLAG WasDataEntry;	     // No need to update the display
+extern PER_INSTANCE char TraceBuffer[];           // Display current instruction
 #ifndef REALBUILD
-extern char LastDisplayedText[NUMALPHA + 1];	   // This is for the emulator (clipboard)
-extern char LastDisplayedNumber[NUMBER_LENGTH+1]; // Used to display with fonts in emulators
-extern char LastDisplayedExponent[EXPONENT_LENGTH+1]; // Used to display with fonts in emulators
+extern PER_INSTANCE char LastDisplayedText[NUMALPHA + 1];	   // This is for the emulator (clipboard)
+extern PER_INSTANCE char LastDisplayedNumber[NUMBER_LENGTH+1]; // Used to display with fonts in emulators
+extern PER_INSTANCE char LastDisplayedExponent[EXPONENT_LENGTH+1]; // Used to display with fonts in emulators
 #endif
-extern FLAG Tracing;		     // Set by SF T for INFRARED builds
+extern PER_INSTANCE FLAG Tracing;		     // Set by SF T for INFRARED builds
 #ifdef CONSOLE
-extern unsigned long long int instruction_count;
-extern int view_instruction_counter;
+extern PER_INSTANCE unsigned long long int instruction_count;
+extern PER_INSTANCE int view_instruction_counter;
+extern PER_INSTANCE int batch_mode;			// No terminal, results are printed at the end
+extern PER_INSTANCE unsigned int batch_error;	// Last error reported
+#ifdef INCLUDE_PROFILER
+extern PER_INSTANCE int profiling;		// Program steps are timed and counted
+#endif
 #endif
 #ifdef RP_PREFIX
-extern SMALL_INT RectPolConv; // 1 - R->P just done; 2 - P->R just done
+extern PER_INSTANCE SMALL_INT RectPolConv; // 1 - R->P just done; 2 - P->R just done
 #endif
 #if INTERRUPT_XROM_TICKS > 0
 extern volatile unsigned int OnKeyTicks; // ON (EXIT) key has been held down for this many ticks
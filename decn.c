@@ -140,6 +140,54 @@ decNumber *dn_max(decNumber *r, const decNumber *a, const decNumber *b) {
 	return decNumberMax(r, a, b, &Ctx);
 }
 
+/* Fused multiply and accumulate.
+ * The accumulator holds the product of two working precision numbers
+ * exactly and sums of them almost always so, only the final result is
+ * rounded.  Packing acc->n directly rounds once to the register format.
+ */
+static void acc_context(decContext *ctx) {
+	*ctx = Ctx;
+	ctx->digits = DN_ACC_DIGITS;
+}
+
+decNumber *dn_acc_init(decAccumulator *acc, const decNumber *x) {
+	if (x == NULL)
+		return decNumberZero(&acc->n);
+	return decNumberCopy(&acc->n, x);
+}
+
+void dn_acc_mac(decAccumulator *acc, const decNumber *a, const decNumber *b) {
+	decContext ctx;
+	decAccumulator p;
+
+	acc_context(&ctx);
+	decNumberMultiply(&p.n, a, b, &ctx);
+	decNumberAdd(&acc->n, &acc->n, &p.n, &ctx);
+}
+
+void dn_acc_msc(decAccumulator *acc, const decNumber *a, const decNumber *b) {
+	decContext ctx;
+	decAccumulator p;
+
+	acc_context(&ctx);
+	decNumberMultiply(&p.n, a, b, &ctx);
+	decNumberSubtract(&acc->n, &acc->n, &p.n, &ctx);
+}
+
+decNumber *dn_acc_round(decNumber *r, const decAccumulator *acc) {
+	return dn_plus(r, &acc->n);
+}
+
+/* r = a * b + c with a single rounding
+ */
+decNumber *dn_fma(decNumber *r, const decNumber *a, const decNumber *b, const decNumber *c) {
+	decAccumulator acc;
+
+	dn_acc_init(&acc, c);
+	dn_acc_mac(&acc, a, b);
+	return dn_acc_round(r, &acc);
+}
+
 decNumber *dn_abs(decNumber *r, const decNumber *a) {
 	return decNumberAbs(r, a, &Ctx);
 }
@@ -750,20 +798,62 @@ decNumber *do_log(decNumber *r, const decNumber *x, const decNumber *base) {
  *
  * Take advantage of the fact that we store our numbers in the form: m * 10^e
  * so log(m * 10^e) = log(m) + e * log(10)
- * do this so that m is always in the range 0.1 <= m < 2.  However if the number
- * is already in the range 0.5 .. 1.5, this step is skipped.
+ * do this so that m is always in the range 1 <= m < 10.  However if the number
+ * is already in the range 0.5 .. 1.5, this step is skipped and values below
+ * 1 are inverted instead.  Values within 0.1 of unity go straight to the
+ * series, since every further step would only add rounding error to a small
+ * result.
  *
- * Then use the fact that ln(x^2) = 2 * ln(x) to range reduce the mantissa
- * into 1/sqrt(2) <= m < 2.
+ * Otherwise range reduce the mantissa into 1 <= m < 1.01 by dividing out its
+ * leading digit, its tenths and its hundredths in turn.  The logarithms of
+ * these divisors come from tables.  All of them are positive so nothing
+ * cancels.
  *
  * Finally, apply the series expansion:
  *   ln(x) = 2(a+a^3/3+a^5/5+...) where a=(x-1)/(x+1)
- * which converges quickly for an argument near unity.
+ * which converges quickly for an argument this near unity.
+ */
+static const decNumber *const ln_digits[] = {
+	&const_ln2, &const_ln3, &const_ln4, &const_ln5,
+	&const_ln6, &const_ln7, &const_ln8, &const_ln9
+};
+
+static const decNumber *const ln_tenths[] = {
+	&const_ln1_1, &const_ln1_2, &const_ln1_3, &const_ln1_4, &const_ln1_5,
+	&const_ln1_6, &const_ln1_7, &const_ln1_8, &const_ln1_9
+};
+
+static const decNumber *const ln_hundredths[] = {
+	&const_ln1_01, &const_ln1_02, &const_ln1_03, &const_ln1_04, &const_ln1_05,
+	&const_ln1_06, &const_ln1_07, &const_ln1_08, &const_ln1_09
+};
+
+/* Return the digit of z at 10^-scale
+ */
+static int ln_digit(const decNumber *z, int scale) {
+	decNumber t, u;
+
+	decNumberCopy(&t, z);
+	t.exponent += scale;
+	decNumberTrunc(&u, &t);
+	return dn_to_int(&u) % 10;
+}
+
+/* Divide z by d * 10^-scale and add the tabled logarithm of the divisor to s
  */
+static void ln_reduce(decNumber *z, decNumber *s, int d, int scale, const decNumber *ln) {
+	decNumber c;
+
+	int_to_dn(&c, d);
+	c.exponent -= scale;
+	dn_divide(z, z, &c);
+	dn_add(s, s, ln);
+}
+
 decNumber *dn_ln(decNumber *r, const decNumber *x) {
-	decNumber z, t, f, n, m, i, v, w, e;
+	decNumber z, t, n, m, i, v, w, e, s, lim;
 	const decNumber *tol = is_dblmode() ? &const_1e_37 : &const_1e_32;
-	int expon;
+	int expon, invert = 0, reduce = 1, d;
 
 	if (decNumberIsSpecial(x)) {
 		if (decNumberIsNaN(x) || decNumberIsNegative(x))
@@ -776,45 +866,62 @@ decNumber *dn_ln(decNumber *r, const decNumber *x) {
 		return set_neginf(r);
 	}
 	decNumberCopy(&z, x);
-	decNumberCopy(&f, &const_2);
 	dn_m1(&t, x);
 	dn_abs(&v, &t);
 	if (dn_gt(&v, &const_0_5)) {
-		expon = z.exponent + z.digits;
-		z.exponent = -z.digits;
-	} else
+		expon = z.exponent + z.digits - 1;
+		z.exponent = 1 - z.digits;
+	} else {
 		expon = 0;
-
-/* The too high case never happens
-	while (dn_le(&const_2, &z)) {
-		dn_mul2(&f, &f);
-		dn_sqrt(&z, &z);
+		if (! dn_gt(&v, &const_0_1))
+			reduce = 0;
+		else if (dn_lt(&z, &const_1)) {
+			decNumberRecip(&z, &z);
+			invert = 1;
+		}
 	}
-*/
-	// Range reduce the value by repeated square roots.
-	// Making the constant here larger will reduce the number of later
-	// iterations at the expense of more square root operations.
-	while (dn_le(&z, &const_root2on2)) {
-		dn_mul2(&f, &f);
-		dn_sqrt(&z, &z);
+
+	// Table driven range reduction, see above
+	decNumberZero(&s);
+	if (reduce) {
+		d = ln_digit(&z, 0);
+		if (d > 1)
+			ln_reduce(&z, &s, d, 0, ln_digits[d - 2]);
+		d = ln_digit(&z, 1);
+		if (d > 0)
+			ln_reduce(&z, &s, 10 + d, 1, ln_tenths[d - 1]);
+		d = ln_digit(&z, 2);
+		if (d > 0)
+			ln_reduce(&z, &s, 100 + d, 2, ln_hundredths[d - 1]);
 	}
+
 	dn_p1(&t, &z);
 	dn_m1(&v, &z);
-	dn_divide(&n, &v, &t);
-	decNumberCopy(&v, &n);
-	decNumberSquare(&m, &v);
-	decNumberCopy(&i, &const_3);
-
-	for (;;) {
-		dn_multiply(&n, &m, &n);
-		dn_divide(&e, &n, &i);
-		dn_add(&w, &v, &e);
-		if (relative_error(&w, &v, tol))
-			break;
-		decNumberCopy(&v, &w);
-		dn_p2(&i, &i);
+	if (dn_eq0(&v))
+		decNumberZero(&w);
+	else {
+		dn_divide(&n, &v, &t);
+		decNumberCopy(&v, &n);
+		decNumberSquare(&m, &v);
+		decNumberCopy(&i, &const_3);
+		// The sum never drops below a so an absolute limit will do
+		dn_multiply(&t, &v, tol);
+		dn_abs(&lim, &t);
+
+		for (;;) {
+			dn_multiply(&n, &m, &n);
+			dn_divide(&e, &n, &i);
+			dn_add(&w, &v, &e);
+			if (dn_abs_lt(&e, &lim))
+				break;
+			decNumberCopy(&v, &w);
+			dn_p2(&i, &i);
+		}
+		dn_mul2(&w, &w);
 	}
-	dn_multiply(r, &f, &w);
+	dn_add(r, &s, &w);
+	if (invert)
+		dn_minus(r, r);
 	if (expon == 0)
 		return r;
 	int_to_dn(&e, expon);
@@ -859,6 +966,57 @@ decNumber *decNumberPow_1(decNumber *r, const decNumber *x) {
 	return r;
 }
 
+#ifdef INCLUDE_NATIVE_FIBONACCI
+/* Fibonacci numbers.  Integers up to FIB_DOUBLING in magnitude go by fast
+ * doubling from (F(k), F(k+1)):
+ *
+ *	F(2k) = F(k) (2 F(k+1) - F(k)),	F(2k+1) = F(k)^2 + F(k+1)^2
+ *
+ * Every term is positive so the result is exact while it fits and only a
+ * few digits are lost after.  Larger and non-integer arguments follow the
+ * XROM routine, (phi^x - (-1)^x / phi^x) / sqrt(5).
+ */
+#define FIB_DOUBLING	20000
+
+decNumber *decNumberFib(decNumber *r, const decNumber *x) {
+	decNumber a, b, c, t, u;
+	int n, bit;
+
+	dn_abs(&t, x);
+	int_to_dn(&u, FIB_DOUBLING);
+	if (! is_int(x) || ! dn_lt(&t, &u)) {
+		dn_power(&t, &const_phi, x);
+		decNumberPow_1(&u, x);
+		dn_divide(&a, &u, &t);
+		dn_subtract(&b, &t, &a);
+		dn_mul2(&t, &const_phi);
+		dn_m1(&u, &t);
+		return dn_divide(r, &b, &u);
+	}
+	n = dn_to_int(&t);
+	decNumberZero(&a);
+	dn_1(&b);
+	for (bit = 1; bit <= n; bit <<= 1);
+	while ((bit >>= 1) != 0) {
+		dn_mul2(&t, &b);
+		dn_subtract(&u, &t, &a);
+		dn_multiply(&c, &a, &u);		// F(2k)
+		decNumberSquare(&t, &a);
+		decNumberSquare(&u, &b);
+		dn_add(&b, &t, &u);			// F(2k+1)
+		if (n & bit) {
+			dn_add(&t, &c, &b);
+			decNumberCopy(&a, &b);
+			decNumberCopy(&b, &t);
+		} else
+			decNumberCopy(&a, &c);
+	}
+	if (decNumberIsNegative(x) && (n & 1) == 0)
+		return dn_minus(r, &a);
+	return decNumberCopy(r, &a);
+}
+#endif
+
 /* Square - this almost certainly could be done more efficiently
  */
 decNumber *decNumberSquare(decNumber *r, const decNumber *x) {
@@ -952,9 +1110,10 @@ decNumber *decNumberBigMod(decNumber *res, const decNumber *x, const decNumber *
 }
 
 
-/* Calculate sin and cos by Taylor series
+#ifdef INCLUDE_BENCHMARKS
+/* The plain Taylor series sincosTaylor used to be, kept to verify it against
  */
-void sincosTaylor(const decNumber *a, decNumber *sout, decNumber *cout) {
+void sincos_series(const decNumber *a, decNumber *sout, decNumber *cout) {
 	sincosNumber a2, t, j, z, s, c;
 	int i, fins = sout == NULL, finc = cout == NULL;
 	const int digits = Ctx.digits;
@@ -1000,6 +1159,129 @@ void sincosTaylor(const decNumber *a, decNumber *sout, decNumber *cout) {
 	if (cout != NULL)
 		dn_plus(cout, &c.n);
 }
+#endif
+
+
+/* Calculate sin and cos by table and Taylor series.
+ *
+ * The argument is reduced by multiples of pi/2 into [-pi/4, pi/4] and then
+ * by the nearest multiple of 1/8 whose sine and cosine are tabled.  The
+ * remainder is at most 1/16, so a short polynomial with tabled inverse
+ * factorials does, evaluated by Horner's rule without any division, and
+ * the addition theorems put the pieces back together.
+ */
+static const decNumber *const sincos_sin[] = {
+	&const_sin1_8, &const_sin2_8, &const_sin3_8,
+	&const_sin4_8, &const_sin5_8, &const_sin6_8
+};
+
+static const decNumber *const sincos_cos[] = {
+	&const_cos1_8, &const_cos2_8, &const_cos3_8,
+	&const_cos4_8, &const_cos5_8, &const_cos6_8
+};
+
+static const decNumber *const invfact[] = {
+	&const_1, &const_1, &const_invfact2, &const_invfact3,
+	&const_invfact4, &const_invfact5, &const_invfact6, &const_invfact7,
+	&const_invfact8, &const_invfact9, &const_invfact10, &const_invfact11,
+	&const_invfact12, &const_invfact13, &const_invfact14, &const_invfact15,
+	&const_invfact16, &const_invfact17, &const_invfact18, &const_invfact19,
+	&const_invfact20, &const_invfact21, &const_invfact22, &const_invfact23,
+	&const_invfact24, &const_invfact25
+};
+#define SINCOS_TERMS	((int) (sizeof(invfact) / sizeof(*invfact)) / 2)
+
+/* Decimal order of magnitude, x < 10^dn_magnitude(x)
+ */
+#define dn_magnitude(x)	((x)->exponent + (x)->digits)
+
+/* Sum (-1)^n g^n / (2n + odd)! by Horner's rule over the terms that matter.
+ * The partial sums of the higher terms only need as many digits as they
+ * contribute to the result.
+ */
+static void sincos_poly(decNumber *r, const decNumber *g, int odd) {
+	const int eg = dn_magnitude(g);
+	int n = 0, m;
+
+	decNumberZero(r);
+	if (! decNumberIsZero(g))
+		while (n < SINCOS_TERMS - 1 && (n + 1) * eg + dn_magnitude(invfact[2 * n + 2 + odd]) > -SINCOS_DIGITS)
+			n++;
+	for (; n >= 0; n--) {
+		m = n * eg + dn_magnitude(invfact[2 * n + odd]);
+		Ctx.digits = m < 0 ? SINCOS_DIGITS + m + 2 : SINCOS_DIGITS;
+		dn_multiply(r, r, g);
+		dn_subtract(r, invfact[2 * n + odd], r);
+	}
+	Ctx.digits = SINCOS_DIGITS;
+}
+
+void sincosTaylor(const decNumber *a, decNumber *sout, decNumber *cout) {
+	sincosNumber r, f, g, t, u, sf, cf, s, c;
+	const int digits = Ctx.digits;
+	int q, k;
+
+	Ctx.digits = SINCOS_DIGITS;
+
+	// Quadrant: the quotient only has to be nearly right
+	dn_multiply(&t.n, a, &const__1onPI);
+	dn_multiply(&u.n, &t.n, &const__2);
+	decNumberRound(&t.n, &u.n);
+	q = dn_to_int(&t.n);
+	dn_multiply(&u.n, &t.n, &const_PIon2_sincos);
+	dn_subtract(&r.n, a, &u.n);
+
+	// Table entry
+	dn_multiply(&u.n, &r.n, &const_8);
+	decNumberRound(&t.n, &u.n);
+	k = dn_to_int(&t.n);
+	int_to_dn(&t.n, k * 125);
+	t.n.exponent -= 3;
+	dn_subtract(&f.n, &r.n, &t.n);
+
+	decNumberSquare(&g.n, &f.n);
+	sincos_poly(&cf.n, &g.n, 0);
+	sincos_poly(&t.n, &g.n, 1);
+	dn_multiply(&sf.n, &t.n, &f.n);
+
+	if (k == 0) {
+		decNumberCopy(&s.n, &sf.n);
+		decNumberCopy(&c.n, &cf.n);
+	} else {
+		const decNumber *const sk = sincos_sin[(k < 0 ? -k : k) - 1];
+		const decNumber *const ck = sincos_cos[(k < 0 ? -k : k) - 1];
+
+		// sin(x+y) = sin x cos y + cos x sin y, cos(x+y) = cos x cos y - sin x sin y
+		dn_multiply(&t.n, sk, &cf.n);
+		dn_multiply(&u.n, ck, &sf.n);
+		if (k < 0)
+			dn_subtract(&s.n, &u.n, &t.n);
+		else
+			dn_add(&s.n, &t.n, &u.n);
+		dn_multiply(&t.n, ck, &cf.n);
+		dn_multiply(&u.n, sk, &sf.n);
+		if (k < 0)
+			dn_add(&c.n, &t.n, &u.n);
+		else
+			dn_subtract(&c.n, &t.n, &u.n);
+	}
+
+	// Undo the quadrant reduction
+	if (q & 1) {
+		decNumberCopy(&t.n, &s.n);
+		decNumberCopy(&s.n, &c.n);
+		dn_minus(&c.n, &t.n);
+	}
+	if (q & 2) {
+		dn_minus(&s.n, &s.n);
+		dn_minus(&c.n, &c.n);
+	}
+	Ctx.digits = digits;
+	if (sout != NULL)
+		dn_plus(sout, &s.n);
+	if (cout != NULL)
+		dn_plus(cout, &c.n);
+}
 
 
 /*
@@ -1714,12 +1996,78 @@ const decNumber *const gamma_consts[21] = {
 	&const_gammaC19, &const_gammaC20, &const_gammaC21,
 };
 
+#ifdef INCLUDE_GAMMA_CACHE
+/* The last few results of dn_LnGamma for the current precision.  An argument
+ * next to a remembered one is derived from it by ln x! = ln (x-1)! + ln x,
+ * but only a limited number of times in a row, so the rounding errors stay
+ * well below the displayed digits.
+ */
+#define GAMMA_CACHE_SIZE	8
+#define GAMMA_CACHE_CHAIN	16
+
+static PER_INSTANCE struct {
+	decNumber x, r;
+	unsigned char digits;		// Ctx.digits of the result, zero if unused
+	unsigned char chain;		// Steps since the last full evaluation
+} GammaCache[GAMMA_CACHE_SIZE];
+static PER_INSTANCE unsigned char GammaCacheNext;
+
+static void lngamma_remember(const decNumber *x, const decNumber *r, int chain) {
+	const int i = GammaCacheNext;
+
+	GammaCacheNext = (i + 1) % GAMMA_CACHE_SIZE;
+	decNumberCopy(&GammaCache[i].x, x);
+	decNumberCopy(&GammaCache[i].r, r);
+	GammaCache[i].digits = Ctx.digits;
+	GammaCache[i].chain = chain;
+}
+
+static int lngamma_cached(decNumber *res, const decNumber *x) {
+	decNumber xm1, xp1, t;
+	int i, below = -1, above = -1;
+
+	dn_m1(&xm1, x);
+	dn_p1(&xp1, x);
+	for (i = 0; i < GAMMA_CACHE_SIZE; i++) {
+		if (GammaCache[i].digits != Ctx.digits)
+			continue;
+		if (dn_eq(&GammaCache[i].x, x)) {
+			decNumberCopy(res, &GammaCache[i].r);
+			return 1;
+		}
+		if (GammaCache[i].chain < GAMMA_CACHE_CHAIN) {
+			if (dn_eq(&GammaCache[i].x, &xm1))
+				below = i;
+			else if (dn_eq(&GammaCache[i].x, &xp1))
+				above = i;
+		}
+	}
+	if (below >= 0) {
+		dn_ln(&t, x);
+		dn_add(res, &GammaCache[below].r, &t);
+		i = below;
+	} else if (above >= 0) {
+		dn_ln(&t, &xp1);
+		dn_subtract(res, &GammaCache[above].r, &t);
+		i = above;
+	} else
+		return 0;
+	lngamma_remember(x, res, GammaCache[i].chain + 1);
+	return 1;
+}
+#endif
+
+// ln x! by the Lanczos approximation, x > -1
 static void dn_LnGamma(decNumber *res, const decNumber *x) {
 	decNumber r, s, t, u, v;
 	int k;
 #ifdef DUMP
 	FILE *f = fopen("calc.out","a");
 	DUMP(x, "z");
+#endif
+#ifdef INCLUDE_GAMMA_CACHE
+	if (lngamma_cached(res, x))
+		return;
 #endif
 	decNumberZero(&s);
 	dn_add(&t, x, &const_21);
@@ -1734,7 +2082,7 @@ static void dn_LnGamma(decNumber *res, const decNumber *x) {
 	DUMP(&t, "sum");
 	DUMP(&s, "ln");
 #endif
-//		r = z + g + .5;
+//		r = z + g + .5;
 	dn_add(&r, x, &const_gammaR);
 #ifdef DUMP
 	DUMP(&r, "r");
@@ -1750,6 +2098,9 @@ static void dn_LnGamma(decNumber *res, const decNumber *x) {
 
 	dn_subtract(&u, &v, &r);
 	dn_add(res, &u, &s);
+#ifdef INCLUDE_GAMMA_CACHE
+	lngamma_remember(x, res, 0);
+#endif
 
 #ifdef DUMP
 	DUMP(res, "res");
@@ -1757,6 +2108,41 @@ static void dn_LnGamma(decNumber *res, const decNumber *x) {
 #endif
 }
 
+#ifdef GAMMA_FAST_INTEGERS
+static const decNumber *const factorials[16] = {
+	&const_1,	&const_fact16,	&const_fact32,	&const_fact48,
+	&const_fact64,	&const_fact80,	&const_fact96,	&const_fact112,
+	&const_fact128,	&const_fact144,	&const_fact160,	&const_fact176,
+	&const_fact192,	&const_fact208,	&const_fact224,	&const_fact240,
+};
+
+/* x! for integers and half integers 0 <= x + 1/2 < 256 from the table and
+ * at most fifteen multiplications or from sqrt(PI) and the product of
+ * 1/2, 3/2, ..., x.  Returns zero for any other argument.
+ */
+static int fast_factorial(decNumber *res, const decNumber *x) {
+	decNumber t;
+	int n, k;
+
+	if (is_int(x)) {
+		n = dn_to_int(x);
+		decNumberCopy(res, factorials[n >> 4]);
+		for (k = (n & ~15) + 1; k <= n; k++) {
+			int_to_dn(&t, k);
+			dn_multiply(res, res, &t);
+		}
+		return 1;
+	}
+	dn_add(&t, x, &const_0_5);
+	if (! is_int(&t))
+		return 0;
+	decNumberCopy(res, &const_sqrtPI);
+	for (decNumberCopy(&t, &const_0_5); dn_le(&t, x); dn_inc(&t))
+		dn_multiply(res, res, &t);
+	return 1;
+}
+#endif
+
 // common code for the [GAMMA] and LN[GAMMA]
 static decNumber *Gamma_LnGamma(decNumber *res, const decNumber *xin, const int ln) {
 	decNumber x, t;
@@ -1790,15 +2176,11 @@ static decNumber *Gamma_LnGamma(decNumber *res, const decNumber *xin, const int
 	} else {
 		dn_m1(&x, xin);
 #ifdef GAMMA_FAST_INTEGERS
-		// Provide a fast path evaluation for positive integer arguments that aren't too large
-		// The threshold for overflow is 205! (i.e. 204! is within range and 205! isn't).
-		// Without introducing a new constant, we've got 150 or 256 to choose from.
-		if (is_int(&x) && ! dn_eq0(xin) && dn_lt(&x, &const_256)) {
-			dn_1(res);
-			while (! dn_eq0(&x)) {
-				dn_multiply(res, res, &x);
-				dn_m1(&x, &x);
-			}
+		// Provide a fast path evaluation for positive integer and half integer arguments
+		// that aren't too large.  The threshold for overflow is 205! (i.e. 204! is within
+		// range and 205! isn't).  Without introducing a new constant, we've got 150 or
+		// 256 to choose from.
+		if (dn_lt(&x, &const_256) && fast_factorial(res, &x)) {
 			if (ln)
 				return dn_ln(res, res);
 			return res;
@@ -2172,11 +2554,11 @@ static decNumber *gcf(decNumber *res, const decNumber *a, const decNumber *x, co
 	return dn_multiply(res, &t, &h);
 }
 
-decNumber *decNumberGammap(decNumber *res, const decNumber *x, const decNumber *a) {
+/* Incomplete gamma function, lower or upper and optionally regularised.
+ * The commands pick the variant from the opcode, C callers name it.
+ */
+decNumber *dn_gammainc(decNumber *res, const decNumber *x, const decNumber *a, int regularised, int upper) {
 	decNumber z, lga;
-	const int op = XeqOpCode - (OP_DYA | OP_GAMMAg);
-	const int regularised = op & 2;
-	const int upper = op & 1;
 
 	if (decNumberIsNegative(x) || dn_le0(a) ||
 			decNumberIsNaN(x) || decNumberIsNaN(a) || decNumberIsInfinite(a)) {
@@ -2217,6 +2599,12 @@ invert:	if (regularised)
 	return dn_subtract(res, &z, res);
 }
 
+decNumber *decNumberGammap(decNumber *res, const decNumber *x, const decNumber *a) {
+	const int op = XeqOpCode - (OP_DYA | OP_GAMMAg);
+
+	return dn_gammainc(res, x, a, op & 2, op & 1);
+}
+
 #ifdef INCLUDE_FACTOR
 decNumber *decFactor(decNumber *r, const decNumber *x) {
 	int sgn;
@@ -2246,3 +2634,171 @@ decNumber *decRecv(decNumber *r, const decNumber *x) {
 	return r;
 }
 #endif
+
+
+#ifdef INCLUDE_NATIVE_ORTHOPOLYS
+/* Orthogonal polynomials by their three term recurrences
+ *
+ *	t(k) = (a(k) + c(k) x) t(k-1) - b(k) t(k-2)
+ *
+ * Legendre's and Laguerre's coefficients are fractions, the last ones used
+ * are remembered so evaluating the same order at many points needs no
+ * divisions.  The argument checks are those of the XROM versions.
+ */
+enum ortho_poly {
+	ORTHO_LEGENDRE_PN, ORTHO_CHEBYCHEV_TN, ORTHO_CHEBYCHEV_UN,
+	ORTHO_LAGUERRE, ORTHO_HERMITE_HE, ORTHO_HERMITE_H
+};
+
+#define ORTHO_MEMO_ORDER	64
+
+static PER_INSTANCE struct {
+	decNumber param;		// Laguerre's alpha
+	unsigned char type;
+	unsigned char digits;		// Ctx.digits of the coefficients
+	unsigned char n;		// coefficients known for orders 2 .. n
+	struct {
+		decNumber a, b, c;
+	} coeff[ORTHO_MEMO_ORDER - 1];
+} OrthoMemo;
+
+static void ortho_coefficients(decNumber *a, decNumber *b, decNumber *c, int k, const decNumber *param, enum ortho_poly type) {
+	decNumber s, t, u;
+
+	int_to_dn(&t, k);
+	if (type == ORTHO_LEGENDRE_PN) {
+		decNumberZero(a);
+		dn_mul2(&s, &t);
+		dn_dec(&s);
+		dn_divide(c, &s, &t);			// (2k - 1) / k
+		dn_m1(&s, &t);
+		dn_divide(b, &s, &t);			// (k - 1) / k
+	} else {
+		dn_mul2(&s, &t);
+		dn_dec(&s);
+		dn_add(&u, &s, param);
+		dn_divide(a, &u, &t);			// (2k - 1 + alpha) / k
+		decNumberRecip(&s, &t);
+		dn_minus(c, &s);			// -1 / k
+		dn_m1(&s, &t);
+		dn_add(&u, &s, param);
+		dn_divide(b, &u, &t);			// (k - 1 + alpha) / k
+	}
+}
+
+static void ortho_memo(decNumber *a, decNumber *b, decNumber *c, int k, const decNumber *param, enum ortho_poly type) {
+	if (k > ORTHO_MEMO_ORDER) {
+		ortho_coefficients(a, b, c, k, param, type);
+		return;
+	}
+	if (OrthoMemo.type != type || OrthoMemo.digits != Ctx.digits ||
+			(type == ORTHO_LAGUERRE && ! dn_eq(&OrthoMemo.param, param))) {
+		OrthoMemo.type = type;
+		OrthoMemo.digits = Ctx.digits;
+		OrthoMemo.n = 1;
+		if (type == ORTHO_LAGUERRE)
+			decNumberCopy(&OrthoMemo.param, param);
+	}
+	while (OrthoMemo.n < k) {
+		const int i = ++OrthoMemo.n;
+
+		ortho_coefficients(&OrthoMemo.coeff[i - 2].a, &OrthoMemo.coeff[i - 2].b,
+				&OrthoMemo.coeff[i - 2].c, i, param, type);
+	}
+	decNumberCopy(a, &OrthoMemo.coeff[k - 2].a);
+	decNumberCopy(b, &OrthoMemo.coeff[k - 2].b);
+	decNumberCopy(c, &OrthoMemo.coeff[k - 2].c);
+}
+
+static decNumber *ortho_poly(decNumber *r, const decNumber *param, const decNumber *rn, const decNumber *x, const enum ortho_poly type) {
+	decNumber t0, t1, t, u, v, A, B, a, b, c;
+	int i, n;
+
+	if (decNumberIsSpecial(x) || decNumberIsSpecial(rn) || dn_lt0(rn) || ! is_int(rn))
+		return set_NaN(r);
+	if (dn_eq0(rn))
+		return dn_1(r);
+	int_to_dn(&t, 1000);
+	if (! dn_lt(rn, &t))
+		return set_NaN(r);
+	n = dn_to_int(rn);
+	if (type == ORTHO_LAGUERRE) {
+		if (decNumberIsSpecial(param))
+			return set_NaN(r);
+		dn_p1(&t, param);
+		if (dn_le0(&t))
+			return set_NaN(r);
+	}
+
+	// The first two values t0 and t1
+	dn_1(&t0);
+	switch (type) {
+	default:
+		decNumberCopy(&t1, x);
+		break;
+	case ORTHO_HERMITE_H:
+	case ORTHO_CHEBYCHEV_UN:
+		dn_mul2(&t1, x);
+		break;
+	case ORTHO_LAGUERRE:
+		dn_p1(&t, param);
+		dn_subtract(&t1, &t, x);
+		break;
+	}
+
+	// A x and B for the polynomials with integral coefficients
+	if (type == ORTHO_HERMITE_HE)
+		decNumberCopy(&A, x);
+	else
+		dn_mul2(&A, x);
+	dn_1(&B);
+
+	for (i = 2; i <= n; i++) {
+		if (type == ORTHO_LEGENDRE_PN || type == ORTHO_LAGUERRE) {
+			ortho_memo(&a, &b, &c, i, param, type);
+			dn_multiply(&t, &c, x);
+			dn_add(&A, &t, &a);
+			decNumberCopy(&B, &b);
+		} else if (type == ORTHO_HERMITE_HE)
+			int_to_dn(&B, i - 1);
+		else if (type == ORTHO_HERMITE_H)
+			int_to_dn(&B, 2 * (i - 1));
+		dn_multiply(&t, &t1, &A);
+		dn_multiply(&u, &t0, &B);
+		dn_subtract(&v, &t, &u);
+		decNumberCopy(&t0, &t1);
+		decNumberCopy(&t1, &v);
+	}
+	return decNumberCopy(r, &t1);
+}
+
+decNumber *decNumberPolyPn(decNumber *r, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, NULL, y, x, ORTHO_LEGENDRE_PN);
+}
+
+decNumber *decNumberPolyTn(decNumber *r, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, NULL, y, x, ORTHO_CHEBYCHEV_TN);
+}
+
+decNumber *decNumberPolyUn(decNumber *r, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, NULL, y, x, ORTHO_CHEBYCHEV_UN);
+}
+
+decNumber *decNumberPolyLn(decNumber *r, const decNumber *y, const decNumber *x) {
+	decNumber z;
+
+	return ortho_poly(r, decNumberZero(&z), y, x, ORTHO_LAGUERRE);
+}
+
+decNumber *decNumberPolyLnAlpha(decNumber *r, const decNumber *z, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, z, y, x, ORTHO_LAGUERRE);
+}
+
+decNumber *decNumberPolyHEn(decNumber *r, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, NULL, y, x, ORTHO_HERMITE_HE);
+}
+
+decNumber *decNumberPolyHn(decNumber *r, const decNumber *y, const decNumber *x) {
+	return ortho_poly(r, NULL, y, x, ORTHO_HERMITE_H);
+}
+#endif
@@ -42,6 +42,21 @@ extern decNumber *dn_divide(decNumber *r, const decNumber *a, const decNumber *b
 extern decNumber *dn_compare(decNumber *r, const decNumber *a, const decNumber *b);
 extern decNumber *dn_min(decNumber *r, const decNumber *a, const decNumber *b);
 extern decNumber *dn_max(decNumber *r, const decNumber *a, const decNumber *b);
+
+/* A multiply and accumulate register wide enough to hold the exact product
+ * of two working precision numbers.
+ */
+#define DN_ACC_DIGITS	(2 * DECNUMDIGITS + DECDPUN)
+typedef struct {
+	decNumber n;
+	decNumberUnit extra[(DN_ACC_DIGITS - DECNUMDIGITS + DECDPUN - 1) / DECDPUN];
+} decAccumulator;
+
+extern decNumber *dn_acc_init(decAccumulator *acc, const decNumber *x);
+extern void dn_acc_mac(decAccumulator *acc, const decNumber *a, const decNumber *b);
+extern void dn_acc_msc(decAccumulator *acc, const decNumber *a, const decNumber *b);
+extern decNumber *dn_acc_round(decNumber *r, const decAccumulator *acc);
+extern decNumber *dn_fma(decNumber *r, const decNumber *a, const decNumber *b, const decNumber *c);
 extern decNumber *dn_abs(decNumber *r, const decNumber *a);
 extern decNumber *dn_minus(decNumber *r, const decNumber *a);
 extern decNumber *dn_plus(decNumber *r, const decNumber *a);
@@ -93,6 +108,9 @@ extern decNumber *decNumberGCD(decNumber *r, const decNumber *x, const decNumber
 extern decNumber *decNumberLCM(decNumber *r, const decNumber *x, const decNumber *y);
 
 extern decNumber *decNumberPow_1(decNumber *r, const decNumber *x);
+#ifdef INCLUDE_NATIVE_FIBONACCI
+extern decNumber *decNumberFib(decNumber *r, const decNumber *x);
+#endif
 extern decNumber *decNumberPow2(decNumber *r, const decNumber *x);
 extern decNumber *decNumberPow10(decNumber *r, const decNumber *x);
 extern decNumber *decNumberLn1p(decNumber *r, const decNumber *x);
@@ -127,6 +145,16 @@ extern decNumber *do_atan2(decNumber *at, const decNumber *ain, const decNumber
 extern void op_r2p(enum nilop op);
 extern void op_p2r(enum nilop op);
 
+#ifdef INCLUDE_NATIVE_ORTHOPOLYS
+extern decNumber *decNumberPolyPn(decNumber *r, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyTn(decNumber *r, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyUn(decNumber *r, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyLn(decNumber *r, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyLnAlpha(decNumber *r, const decNumber *z, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyHEn(decNumber *r, const decNumber *y, const decNumber *x);
+extern decNumber *decNumberPolyHn(decNumber *r, const decNumber *y, const decNumber *x);
+#endif
+
 extern decNumber *decNumberSinh(decNumber *res, const decNumber *x);
 extern decNumber *decNumberCosh(decNumber *res, const decNumber *x);
 extern decNumber *decNumberTanh(decNumber *res, const decNumber *x);
@@ -147,6 +175,7 @@ extern decNumber *decNumberLnBeta(decNumber *res, const decNumber *x, const decN
 extern decNumber *decNumberERF(decNumber *res, const decNumber *x);
 extern decNumber *decNumberERFC(decNumber *res, const decNumber *x);
 extern decNumber *decNumberGammap(decNumber *res, const decNumber *a, const decNumber *x);
+extern decNumber *dn_gammainc(decNumber *res, const decNumber *x, const decNumber *a, int regularised, int upper);
 
 extern decNumber *decNumberD2G(decNumber *res, const decNumber *x);
 extern decNumber *decNumberD2R(decNumber *res, const decNumber *x);
@@ -170,6 +199,9 @@ extern decNumber *decNumberBooleanOp(decNumber *res, const decNumber *x, const d
 
 extern void dn_sincos(const decNumber *v, decNumber *sinv, decNumber *cosv);
 extern void sincosTaylor(const decNumber *a, decNumber *s, decNumber *c);
+#ifdef INCLUDE_BENCHMARKS
+extern void sincos_series(const decNumber *a, decNumber *s, decNumber *c);
+#endif
 extern void dn_sinhcosh(const decNumber *v, decNumber *sinhv, decNumber *coshv);
 extern void do_asin(decNumber *, const decNumber *);
 extern void do_acos(decNumber *, const decNumber *);
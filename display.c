@@ -28,27 +28,27 @@
 #include "printer.h"
 #include "serial.h"
 
-static enum separator_modes { SEP_NONE, SEP_COMMA, SEP_DOT } SeparatorMode;
-static enum decimal_modes { DECIMAL_DOT, DECIMAL_COMMA } DecimalMode;
+static PER_INSTANCE enum separator_modes { SEP_NONE, SEP_COMMA, SEP_DOT } SeparatorMode;
+static PER_INSTANCE enum decimal_modes { DECIMAL_DOT, DECIMAL_COMMA } DecimalMode;
 
 static void set_status_sized(const char *, int);
 static void set_status(const char *);
 static void set_status_right(const char *);
 static void set_status_graphic(const unsigned char *);
 
-const char *DispMsg;	   // What to display in message area
-short int DispPlot;
+PER_INSTANCE const char *DispMsg;	   // What to display in message area
+PER_INSTANCE short int DispPlot;
 #ifndef REALBUILD
-char LastDisplayedText[NUMALPHA + 1];	   // For clipboard export
-char LastDisplayedNumber[NUMBER_LENGTH + 1];
-char LastDisplayedExponent[EXPONENT_LENGTH + 1];
-char forceDispPlot;
+PER_INSTANCE char LastDisplayedText[NUMALPHA + 1];	   // For clipboard export
+PER_INSTANCE char LastDisplayedNumber[NUMBER_LENGTH + 1];
+PER_INSTANCE char LastDisplayedExponent[EXPONENT_LENGTH + 1];
+PER_INSTANCE char forceDispPlot;
 #endif
 
-FLAG ShowRPN;		   // controls visibility of RPN annunciator
-FLAG JustDisplayed;	   // Avoid duplicate calls to display()
-SMALL_INT IntMaxWindow;    // Number of windows for integer display
-FLAG IoAnnunciator;	   // Status of the little "=" sign
+PER_INSTANCE FLAG ShowRPN;		   // controls visibility of RPN annunciator
+PER_INSTANCE FLAG JustDisplayed;	   // Avoid duplicate calls to display()
+PER_INSTANCE SMALL_INT IntMaxWindow;    // Number of windows for integer display
+PER_INSTANCE FLAG IoAnnunciator;	   // Status of the little "=" sign
 
 /* Message strings
  * Strings starting S7_ are for the lower 7 segment line.  Strings starting S_
@@ -214,6 +214,10 @@ void error_message(const unsigned int e)
 	};
 #endif
 
+#ifdef CONSOLE
+	if (e != ERR_NONE)
+		batch_error = e;
+#endif
 	if (e != ERR_NONE || Running) {
 		const char *p = error_table[e];
 		const char *q = find_char(p, '\0') + 1;
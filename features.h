@@ -42,6 +42,38 @@
 //#define INCLUDE_STOPWATCH
 #endif
 
+// Keep an index of the program regions so label searches don't have to step
+// through the code.  This needs far too much RAM for the real device.
+#if !defined(REALBUILD)
+#define INCLUDE_PROGRAM_INDEX
+#endif
+
+// Run programs from a decoded copy of the program regions instead of fetching
+// and decoding every step again.  This requires the program index.
+#ifdef INCLUDE_PROGRAM_INDEX
+#define INCLUDE_PREDECODED_PROGRAMS
+#endif
+
+// Keep the emulator state in thread local storage so that the console build
+// can run several independent calculators side by side in one process.
+#if defined(CONSOLE) && defined(__GNUC__) && !defined(WIN32)
+#define INCLUDE_MULTI_INSTANCE
+#define PER_INSTANCE __thread
+#else
+#define PER_INSTANCE
+#endif
+
+// Collect execution counts and host time for every program step executed
+// in the console build, see the P key and the profile command.
+#if defined(CONSOLE) && !defined(WIN32)
+#define INCLUDE_PROFILER
+#endif
+
+// Micro benchmarks of the function tables in the console build, see bench.c
+#if defined(CONSOLE) && !defined(WIN32)
+#define INCLUDE_BENCHMARKS
+#endif
+
 // Interrupt XROM code if the EXIT key is held down for at least the number
 // of ticks (100 ms) specified below. Zero disables this feature. Without it
 // the device needs to be reset if XROM code gets stuck in an infinite loop.
@@ -99,6 +131,27 @@
 // both real and complex arguments.  These are implemented in XROM.
 // #define INCLUDE_XROM_BESSEL
 
+// Compute the normal, t, chi squared, F, Poisson and binomial distributions
+// in C rather than XROM.  The C versions follow the XROM algorithms step for
+// step without rounding between steps.  The XROM routines remain and are what
+// the console "dist" command checks these against.  Costs several kilobytes.
+#if !defined(REALBUILD)
+#define INCLUDE_NATIVE_DISTRIBUTIONS
+#endif
+
+// Evaluate the orthogonal polynomials in C rather than XROM.  The recurrence
+// coefficients of the last Legendre or Laguerre polynomial are remembered so
+// that evaluating one order at many points avoids most divisions.
+#if !defined(REALBUILD)
+#define INCLUDE_NATIVE_ORTHOPOLYS
+#endif
+
+// Compute real Fibonacci numbers in C rather than XROM.  Integer arguments
+// use fast doubling and are exact to the working precision.
+#if !defined(REALBUILD)
+#define INCLUDE_NATIVE_FIBONACCI
+#endif
+
 // Inlcude real and complex flavours of the digamma function.  These are
 // implemented in XROM.  The first setting is sufficient for accuracy for
 // single precision, the second needs to be enabled as well to get good
@@ -119,9 +172,10 @@
 // benefit.
 #define USE_RIDDERS
 
-// Include code to find integer factors
-// Space cost 480 bytes.
-// #define INCLUDE_FACTOR
+// Include code to find integer factors by trial division and Pollard's rho
+#if !defined(REALBUILD)
+#define INCLUDE_FACTOR
+#endif
 
 // Include matrix functions better implemented in user code
 // #define SILLY_MATRIX_SUPPORT
@@ -135,9 +189,23 @@
 #define MATRIX_LU_DECOMP
 
 // Include fast path code to calculate factorials and gamma functions
-// for positive integers using a string of multiplications.
+// for positive integers and half integers using a table and a string of
+// multiplications.
 #define GAMMA_FAST_INTEGERS
 
+// Remember the last few log gamma evaluations, so distributions stepping
+// through their arguments don't start from scratch every time.  This takes
+// more RAM than the real device can spare.
+#if !defined(REALBUILD)
+#define INCLUDE_GAMMA_CACHE
+#endif
+
+// Keep the abscissae and weights of the double exponential integrator
+// between integrals, also too large for the real device.
+#if !defined(REALBUILD)
+#define INCLUDE_INTEGRATE_CACHE
+#endif
+
 // Include the flash register recall routines RCF and their variants
 // #define INCLUDE_FLASH_RECALL
 
@@ -151,6 +219,10 @@
 // operations.
 #define INCLUDE_INT_MODULO_OPS
 
+// Use the original 16 bit digits for the double length integer products
+// and quotients instead of machine words.  Slower, kept as a reference.
+// #define DBL_16BIT_LIMBS
+
 // Include code to support integer (truncated) division
 #define INCLUDE_INTEGER_DIVIDE
 
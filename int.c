@@ -558,6 +558,115 @@ long long int intAbs(long long int x) {
 }
 
 #ifndef TINY_BUILD
+/* Double length products and quotients for DBL*, DBL/, DBLR and the
+ * modulo operations.  dbl_mul forms the full 128 bit product (hi:lo) of
+ * two words, dbl_divrem divides (hi:lo) by d returning the low word of the
+ * quotient and the remainder.  The machine word versions are used unless
+ * DBL_16BIT_LIMBS selects the original 16 bit digits as a reference.
+ */
+#if defined(__SIZEOF_INT128__) && ! defined(DBL_16BIT_LIMBS)
+#define DBL_LIMB_64
+#elif ! defined(DBL_16BIT_LIMBS)
+#define DBL_LIMB_32
+#endif
+
+#if defined(DBL_LIMB_64)
+/* The compiler provides double length arithmetic */
+static void dbl_mul(const unsigned long long int a, const unsigned long long int b, unsigned long long int *hi, unsigned long long int *lo) {
+	const unsigned __int128 p = (unsigned __int128) a * b;
+
+	*lo = (unsigned long long int) p;
+	*hi = (unsigned long long int) (p >> 64);
+}
+
+static unsigned long long int dbl_divrem(const unsigned long long int hi, const unsigned long long int lo,
+		const unsigned long long int d, unsigned long long int *rem) {
+	const unsigned __int128 n = ((unsigned __int128) hi << 64) | lo;
+
+	*rem = (unsigned long long int) (n % d);
+	return (unsigned long long int) (n / d);
+}
+
+#elif defined(DBL_LIMB_32)
+/* 32 bit digits, each partial product is a single 32 x 32 -> 64 multiply */
+static void dbl_mul(const unsigned long long int a, const unsigned long long int b, unsigned long long int *hi, unsigned long long int *lo) {
+	const unsigned long long int a0 = (unsigned int) a, a1 = a >> 32;
+	const unsigned long long int b0 = (unsigned int) b, b1 = b >> 32;
+	const unsigned long long int p00 = a0 * b0, p01 = a0 * b1;
+	const unsigned long long int p10 = a1 * b0, p11 = a1 * b1;
+	const unsigned long long int mid = (p00 >> 32) + (unsigned int) p01 + (unsigned int) p10;
+
+	*lo = (mid << 32) | (unsigned int) p00;
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+static int nlz64(unsigned long long int x) {
+	int n = 0;
+
+	if (x == 0)
+		return 64;
+	if (x <= 0x00000000ffffffffull) {n += 32; x <<= 32;}
+	if (x <= 0x0000ffffffffffffull) {n += 16; x <<= 16;}
+	if (x <= 0x00ffffffffffffffull) {n +=  8; x <<=  8;}
+	if (x <= 0x0fffffffffffffffull) {n +=  4; x <<=  4;}
+	if (x <= 0x3fffffffffffffffull) {n +=  2; x <<=  2;}
+	if (x <= 0x7fffffffffffffffull) {n +=  1;}
+	return n;
+}
+
+/* Knuth's Algorithm D for a four digit dividend and two digit divisor in
+ * base 2^32, as divlu in Hacker's Delight.  The high word is reduced first
+ * so the quotient digits fit, the part of the quotient above 64 bits is
+ * dropped.
+ */
+static unsigned long long int dbl_divrem(unsigned long long int hi, const unsigned long long int lo,
+		unsigned long long int d, unsigned long long int *rem) {
+	const unsigned long long int b = 1ull << 32;	// Number base (32 bits).
+	unsigned long long int q1, q0;			// Quotient digits.
+	unsigned long long int rhat;			// A remainder.
+	unsigned long long int dn1, dn0;		// Normalised divisor digits.
+	unsigned long long int un32, un21, un10, un1, un0;
+	int s;
+
+	q1 = hi / d;
+	hi -= q1 * d;
+	if (hi == 0) {					// Single word dividend
+		*rem = lo % d;
+		return lo / d;
+	}
+
+	s = nlz64(d);					// 0 <= s <= 63, hi != 0 so d > 1
+	d <<= s;
+	dn1 = d >> 32;
+	dn0 = d & 0xffffffff;
+	un32 = (hi << s) | (s == 0 ? 0 : lo >> (64 - s));
+	un10 = lo << s;
+	un1 = un10 >> 32;
+	un0 = un10 & 0xffffffff;
+
+	q1 = un32 / dn1;
+	rhat = un32 - q1 * dn1;
+again1:
+	if (q1 >= b || q1 * dn0 > b * rhat + un1) {
+		q1 = q1 - 1;
+		rhat = rhat + dn1;
+		if (rhat < b) goto again1;
+	}
+	un21 = un32 * b + un1 - q1 * d;
+
+	q0 = un21 / dn1;
+	rhat = un21 - q0 * dn1;
+again2:
+	if (q0 >= b || q0 * dn0 > b * rhat + un0) {
+		q0 = q0 - 1;
+		rhat = rhat + dn1;
+		if (rhat < b) goto again2;
+	}
+	*rem = (un21 * b + un0 - q0 * d) >> s;
+	return q1 * b + q0;
+}
+
+#else
 static void breakup(unsigned long long int x, unsigned short xv[4]) {
 	xv[0] = x & 0xffff;
 	xv[1] = (x >> 16) & 0xffff;
@@ -571,50 +680,28 @@ static unsigned long long int packup(unsigned short int x[4]) {
 			(((unsigned long int)x[1]) << 16) |
 			x[0];
 }
-#endif
 
-void intDblMul(enum nilop op) {
-#ifndef TINY_BUILD
-	const enum arithmetic_modes mode = int_mode();
-	unsigned long long int xv, yv;
-	int s;	
+static void dbl_mul(const unsigned long long int a, const unsigned long long int b, unsigned long long int *hi, unsigned long long int *lo) {
 	unsigned short int xa[4], ya[4];
-	unsigned int t[8];
+	unsigned long long int t[9];
 	unsigned short int r[8];
 	int i, j;
 
-	{
-		long long int xr, yr;
-		int sx, sy;
-
-		xr = getX_int();
-		yr = get_reg_n_int(regY_idx);
-
-		xv = extract_value(xr, &sx);
-		yv = extract_value(yr, &sy);
-
-		s = sx != sy;
-	}
-
 	/* Do the multiplication by breaking the values into unsigned shorts
-	 * multiplying them all out and accumulating into unsigned ints.
-	 * Then perform a second pass over the ints to propogate carry.
+	 * multiplying them all out and accumulating into unsigned long longs,
+	 * four products of two shorts can overflow an int.
+	 * Then perform a second pass over the sums to propogate carry.
 	 * Finally, repack into unsigned long long ints.
-	 *
-	 * This isn't terribly efficient especially for shorter word
-	 * sizes but it works.  Special cases for WS <= 16 and/or WS <= 32
-	 * might be worthwhile since the CPU supports these multiplications
-	 * natively.
 	 */
-	breakup(xv, xa);
-	breakup(yv, ya);
+	breakup(a, xa);
+	breakup(b, ya);
 
-	for (i=0; i<8; i++)
+	for (i=0; i<9; i++)
 		t[i] = 0;
 
 	for (i=0; i<4; i++)
 		for (j=0; j<4; j++)
-			t[i+j] += xa[i] * ya[j];
+			t[i+j] += (unsigned int) xa[i] * ya[j];
 
 	for (i=0; i<8; i++) {
 		if (t[i] >= 65536)
@@ -622,36 +709,10 @@ void intDblMul(enum nilop op) {
 		r[i] = t[i];
 	}
 
-	yv = packup(r);
-	xv = packup(r+4);
-
-	i = word_size();
-	if (i != 64)
-		xv = (xv << (64-i)) | (yv >> i);
-
-	setlastX();
-
-	if (s != 0) {
-		if (mode == MODE_2COMP) {
-			yv = mask_value(1 + ~yv);
-			xv = ~xv;
-			if (yv == 0)
-				xv++;
-		} else if (mode == MODE_1COMP) {
-			yv = ~yv;
-			xv = ~xv;
-		} else
-			xv |= topbit_mask();
-	}
-
-	set_reg_n_int(regY_idx, mask_value(yv));
-	setX_int(mask_value(xv));
-	set_overflow(0);
-#endif
+	*lo = packup(r);
+	*hi = packup(r+4);
 }
 
-
-#ifndef TINY_BUILD
 static int nlz(unsigned short int x) {
    int n;
 
@@ -761,18 +822,88 @@ static void divmnu(unsigned short q[], unsigned short r[],
 		r[i] = (un[i] >> s) | (un[i+1] << (16-s));
 }
 
+static unsigned long long int dbl_divrem(const unsigned long long int hi, const unsigned long long int lo,
+		const unsigned long long int d, unsigned long long int *rem) {
+	unsigned short denom[4];
+	unsigned short numer[8];
+	unsigned short quot[8];		// a short divisor gives a long quotient
+	unsigned short rmdr[4];
+	int num_denom;
+	int num_numer;
+
+	xset(quot, 0, sizeof(quot));
+	xset(rmdr, 0, sizeof(rmdr));
+
+	breakup(d, denom);
+	breakup(lo, numer);
+	breakup(hi, numer+4);
+
+	for (num_denom = 4; num_denom > 1 && denom[num_denom-1] == 0; num_denom--);
+	for (num_numer = 8; num_numer > num_denom && numer[num_numer-1] == 0; num_numer--);
+
+	divmnu(quot, rmdr, numer, denom, num_numer, num_denom);
+
+	*rem = packup(rmdr);
+	return packup(quot);
+}
+#endif
+#endif
+
+void intDblMul(enum nilop op) {
+#ifndef TINY_BUILD
+	const enum arithmetic_modes mode = int_mode();
+	unsigned long long int xv, yv;
+	int s;
+	int i;
+
+	{
+		long long int xr, yr;
+		int sx, sy;
+
+		xr = getX_int();
+		yr = get_reg_n_int(regY_idx);
+
+		xv = extract_value(xr, &sx);
+		yv = extract_value(yr, &sy);
+
+		s = sx != sy;
+	}
+
+	dbl_mul(xv, yv, &xv, &yv);
+
+	i = word_size();
+	if (i != 64)
+		xv = (xv << (64-i)) | (yv >> i);
+
+	setlastX();
+
+	if (s != 0) {
+		if (mode == MODE_2COMP) {
+			yv = mask_value(1 + ~yv);
+			xv = ~xv;
+			if (yv == 0)
+				xv++;
+		} else if (mode == MODE_1COMP) {
+			yv = ~yv;
+			xv = ~xv;
+		} else
+			xv |= topbit_mask();
+	}
+
+	set_reg_n_int(regY_idx, mask_value(yv));
+	setX_int(mask_value(xv));
+	set_overflow(0);
+#endif
+}
+
+
+#ifndef TINY_BUILD
 static unsigned long long int divmod(const long long int z, const long long int y,
 		const long long int x, int *sx, int *sy, unsigned long long *rem) {
 	const enum arithmetic_modes mode = int_mode();
 	const unsigned int ws = word_size();
 	const long long int tbm = topbit_mask();
 	unsigned long long int d, h, l;
-	unsigned short denom[4];
-	unsigned short numer[8];
-	unsigned short quot[5];
-	unsigned short rmdr[4];
-	int num_denom;
-	int num_numer;
 
 	l = (unsigned long long int)z;		// Numerator low
 	h = (unsigned long long int)y;		// Numerator high
@@ -808,20 +939,7 @@ static unsigned long long int divmod(const long long int z, const long long int
 		return 0;
 	}
 
-	xset(quot, 0, sizeof(quot));
-	xset(rmdr, 0, sizeof(rmdr));
-
-	breakup(d, denom);
-	breakup(l, numer);
-	breakup(h, numer+4);
-
-	for (num_denom = 4; num_denom > 1 && denom[num_denom-1] == 0; num_denom--);
-	for (num_numer = 8; num_numer > num_denom && numer[num_numer-1] == 0; num_numer--);
-
-	divmnu(quot, rmdr, numer, denom, num_numer, num_denom);
-
-	*rem = packup(rmdr);
-	return packup(quot);
+	return dbl_divrem(h, l, d, rem);
 }
 #endif
 
@@ -1343,23 +1461,12 @@ void intbits(unsigned int arg, enum rarg op) {
 long long int intFib(long long int x) {
 #ifndef TINY_BUILD
 	int sx, s;
-	unsigned long long int v = extract_value(x, &sx);
+	unsigned long long int n = extract_value(x, &sx);
 	const enum arithmetic_modes mode = int_mode();
-	unsigned long long int a0, a1;
-	unsigned int n, i;
+	unsigned long long int a, b, c, d, bit;
 	long long int tbm;
 
-	/* Limit things so we don't loop for too long.
-	 * The actual largest non-overflowing values for 64 bit integers
-	 * are Fib(92) for signed quantities and Fib(93) for unsigned.
-	 * We allow a bit more and maintain the low order digits.
-	 */
-	if (v >= 100) {
-		set_overflow(1);
-		return 0;
-	}
 	set_overflow(0);
-	n = v & 0xff;
 	if (n <= 1)
 		return build_value(n, 0);
 
@@ -1368,54 +1475,153 @@ long long int intFib(long long int x) {
 	 */
 	s = (sx && (n & 1) == 0)?1:0;
 
-	/* Mask to check for overflow */
+	/* Fast doubling from (F(k), F(k+1)) keeping the low order bits:
+	 *	F(2k) = F(k) (2 F(k+1) - F(k))
+	 *	F(2k+1) = F(k)^2 + F(k+1)^2
+	 */
+	a = 0;
+	b = 1;
+	for (bit = 1ull << 63; (bit & n) == 0; bit >>= 1);
+	for (; bit != 0; bit >>= 1) {
+		c = a * (2 * b - a);
+		d = a * a + b * b;
+		if (n & bit) {
+			a = d;
+			b = c + d;
+		} else {
+			a = c;
+			b = d;
+		}
+	}
+
+	/* The sequence grows by less than a factor of two each step, so it
+	 * overflows exactly when the result reaches the top bit, or for
+	 * unsigned the bit above.  Fib(93) is the largest that fits in 64 bits.
+	 */
 	tbm = topbit_mask();
 	if (mode == MODE_UNSIGNED)
 		tbm <<= 1;
-
-	/* Down to the computation.
-	 */
-	a0 = 0;
-	a1 = 1;
-	for (i=1; i<n; i++) {
-		const unsigned long long int anew = a0 + a1;
-		if ((anew & tbm) || anew < a1)
-			set_overflow(1);
-		a0 = a1;
-		a1 = anew;
-	}
-	return build_value(a1, s);
+	if (n > 93 || (tbm != 0 && a >= (unsigned long long int) tbm))
+		set_overflow(1);
+	return build_value(a, s);
 #else
 	return 0;
 #endif
 }
 
 
-/* Calculate (a . b) mod c taking care to avoid overflow */
-static unsigned long long mulmod(const unsigned long long int a, unsigned long long int b, const unsigned long long int c) {
-	unsigned long long int x=0, y=a%c;
+#ifndef TINY_BUILD
+#ifdef DBL_LIMB_64
+/* The compiler provides a double length product */
+static unsigned long long int mulmod(const unsigned long long int a, const unsigned long long int b, const unsigned long long int c) {
+	return (unsigned __int128) a * b % c;
+}
+
+/* Calculate (a ^ b) mod c */
+static unsigned long long int expmod(const unsigned long long int a, unsigned long long int b, const unsigned long long int c) {
+	unsigned long long int x=1 % c, y=a % c;
 	while (b > 0) {
 		if ((b & 1))
-			x = (x+y)%c;
-		y = (y+y)%c;
+			x = mulmod(x, y, c);
+		y = mulmod(y, y, c);
 		b /= 2;
 	}
-	return x % c;
+	return x;
+}
+#else
+/* Calculate (a . b) mod c by a double length product and division */
+static unsigned long long int mulmod_div(const unsigned long long int a, const unsigned long long int b, const unsigned long long int c) {
+	unsigned long long int hi, lo, r;
+
+	dbl_mul(a, b, &hi, &lo);
+	dbl_divrem(hi, lo, c, &r);
+	return r;
+}
+
+/* Montgomery multiplication for odd moduli, R = 2^64.
+ * The constants for the last modulus used are kept since expmod and the
+ * Miller-Rabin test make many multiplications with the same one.
+ */
+static PER_INSTANCE struct {
+	unsigned long long int n;	// the modulus
+	unsigned long long int ninv;	// -1/n mod R
+	unsigned long long int r2;	// R^2 mod n
+} Montgomery;
+
+/* Return (hi:lo) / R mod n for (hi:lo) < n R */
+static unsigned long long int redc(const unsigned long long int hi, const unsigned long long int lo) {
+	const unsigned long long int n = Montgomery.n;
+	unsigned long long int mhi, mlo, u;
+
+	dbl_mul(lo * Montgomery.ninv, n, &mhi, &mlo);
+	u = hi + mhi + (lo != 0);	// the low halves add to zero mod R
+	if (u < hi || u >= n)
+		u -= n;
+	return u;
+}
+
+static unsigned long long int montmul(const unsigned long long int a, const unsigned long long int b) {
+	unsigned long long int hi, lo;
+
+	dbl_mul(a, b, &hi, &lo);
+	return redc(hi, lo);
+}
+
+static void montgomery_setup(const unsigned long long int n) {
+	unsigned long long int inv = n, r;
+	int i;
+
+	if (Montgomery.n == n)
+		return;
+	for (i=0; i<5; i++)		// Newton's iteration, three bits to 96
+		inv *= 2 - n * inv;
+	r = (0 - n) % n;		// R mod n
+	Montgomery.n = n;
+	Montgomery.ninv = 0 - inv;
+	Montgomery.r2 = mulmod_div(r, r, n);
+}
+
+/* Calculate (a . b) mod c taking care to avoid overflow */
+static unsigned long long int mulmod(const unsigned long long int a, const unsigned long long int b, const unsigned long long int c) {
+	if ((c & 1) == 0)
+		return mulmod_div(a, b, c);
+	montgomery_setup(c);
+	return montmul(montmul(a % c, b % c), Montgomery.r2);
 }
 
 /* Calculate (a ^ b) mod c */
 static unsigned long long int expmod(const unsigned long long int a, unsigned long long int b, const unsigned long long int c) {
-	unsigned long long int x=1, y=a;
+	unsigned long long int x, y;
+
+	if ((c & 1) == 0) {
+		x = 1 % c;
+		y = a % c;
+		while (b > 0) {
+			if ((b & 1))
+				x = mulmod_div(x, y, c);
+			y = mulmod_div(y, y, c);
+			b /= 2;
+		}
+		return x;
+	}
+	montgomery_setup(c);
+	x = redc(0, Montgomery.r2);		// 1 . R mod c
+	y = montmul(a % c, Montgomery.r2);	// a . R mod c
 	while (b > 0) {
 		if ((b & 1))
-			x = mulmod(x, y, c);
-		y = mulmod(y, y, c);
+			x = montmul(x, y);
+		y = montmul(y, y);
 		b /= 2;
 	}
-	return (x % c);
+	return redc(0, x);
 }
+#endif
+#endif
 
-/* Test if a number is prime or not using a Miller-Rabin test */
+/* Test if a number is prime or not using a Miller-Rabin test.
+ * Testing with the first twelve primes as witnesses is deterministic for
+ * all 64 bit numbers.
+ */
 #ifndef TINY_BUILD
 static const unsigned char primes[] = {
 	2, 3, 5, 7,	11, 13, 17, 19,
@@ -1429,16 +1635,10 @@ int isPrime(unsigned long long int p) {
 #ifndef TINY_BUILD
 	int i;
 	unsigned long long int s;
-#define PRIME_ITERATION	15
+#define PRIME_ITERATION	12
 
 	if (p < 2)	return 0;
 
-	/* We fail for numbers >= 2^63 */
-	if ((p & 0x8000000000000000ull) != 0) {
-		err(ERR_DOMAIN);
-		return 1;
-	}
-
 	/* Quick check for divisibility by small primes */
 	for (i=0; i<N_PRIMES; i++)
 		if (p == primes[i])
@@ -1474,8 +1674,10 @@ long long int intmodop(long long int z, long long int y, long long int x) {
 	unsigned long long int vz = extract_value(z, &sz);
 	unsigned long long int r;
 
-	if (sx || sy || sz || vx <= 1)
+	if (sx || sy || sz || vx <= 1) {
 		err(ERR_DOMAIN);
+		return 0;
+	}
 	if (XeqOpCode == (OP_TRI | OP_MULMOD))
 		r = mulmod(vz, vy, vx);
 	else
@@ -1489,41 +1691,95 @@ long long int intmodop(long long int z, long long int y, long long int x) {
 #ifdef INCLUDE_FACTOR
 
 #ifndef TINY_BUILD
+/* Trial division runs over the numbers coprime to 30 up to this bound,
+ * anything left without a factor below it goes to Pollard's rho.
+ */
+#define FACTOR_TRIAL	1000
+#define FACTOR_TRIES	20
+#define FACTOR_BATCH	64
 
-// only need 8 terms for factors > 256
-#define MAX_TERMS	8
+static const unsigned char factor_wheel[] = { 4, 2, 4, 2, 4, 6, 2, 6 };
 
-static int dscanOdd(unsigned int d, unsigned int limit, int nd, unsigned int ad[MAX_TERMS])
-{
-	/* given starting odd `d', skip two divisors at a time and thus
-	* scan only the odd numbers.
-	*/
-	int i, j;
-	while (ad[0])
-	{
-		d += 2;
-		if (d > limit) return 0; // limit reached
-		for (i = nd-2; i >= 0; --i)
-		{
-			for (j = i; j < nd-1; ++j)
-			{
-				int v = ad[j] - ad[j+1] - ad[j+1];
-				if (v < 0)
-				{
-					v += d;
-					--ad[j+1];
-					if (v < 0)
-					{
-						v += d;
-						--ad[j+1];
-					}
+static unsigned long long int absdiff(const unsigned long long int a, const unsigned long long int b) {
+	return a > b ? a - b : b - a;
+}
+
+/* Integer square root of the full 64 bit range without touching the flags */
+static unsigned long long int factor_sqrt(const unsigned long long int n) {
+	unsigned long long int r0, r1 = n / 2 + 1;
+
+	do {
+		r0 = r1;
+		r1 = (r0 + n / r0) / 2;
+	} while (r1 < r0);
+	return r0;
+}
+
+/* One step y -> y^2 + c mod n of the pseudo random sequence, c < n */
+static unsigned long long int rho_step(const unsigned long long int y, const unsigned long long int c, const unsigned long long int n) {
+	const unsigned long long int s = mulmod(y, y, n);
+
+	return s >= n - c ? s - (n - c) : s + c;
+}
+
+/* Pollard's rho with Brent's cycle finding on x -> x^2 + c.
+ * The differences are multiplied together and only every FACTOR_BATCH
+ * steps is a gcd taken, if that overshoots to n the last batch is
+ * repeated one step at a time.  Returns a proper factor of the odd
+ * composite n or 0 if none turned up for any of the constants tried.
+ */
+static unsigned long long int pollard_brent(const unsigned long long int n) {
+	unsigned long long int c, x, y, ys, q, g;
+	unsigned int r, k, i, m;
+
+	for (c = 1; c <= FACTOR_TRIES; c++) {
+		y = 2;
+		x = ys = 0;
+		q = 1;
+		g = 1;
+		for (r = 1; g == 1; r += r) {
+			x = y;
+			for (i = 0; i < r; i++)
+				y = rho_step(y, c, n);
+			for (k = 0; k < r && g == 1; k += m) {
+				ys = y;
+				m = r - k < FACTOR_BATCH ? r - k : FACTOR_BATCH;
+				for (i = 0; i < m; i++) {
+					y = rho_step(y, c, n);
+					q = mulmod(q, absdiff(x, y), n);
 				}
-				ad[j] = v;
+				g = int_gcd(q, n);
 			}
-			if (!ad[j]) --nd;
 		}
+		if (g == n) {
+			do {
+				ys = rho_step(ys, c, n);
+				g = int_gcd(absdiff(x, ys), n);
+			} while (g == 1);
+		}
+		if (g != n)
+			return g;
 	}
-	return d;
+	return 0;
+}
+
+/* The least prime factor of n which has none below FACTOR_TRIAL */
+static unsigned long long int least_factor(const unsigned long long int n) {
+	unsigned long long int f, a, b;
+
+	if (n < FACTOR_TRIAL * FACTOR_TRIAL || isPrime(n))
+		return n;
+	f = factor_sqrt(n);
+	if (f * f == n)
+		return least_factor(f);
+	f = pollard_brent(n);
+	if (f == 0)
+		return 0;
+	a = least_factor(f);
+	b = least_factor(n / f);
+	if (a == 0 || b == 0)
+		return 0;
+	return a < b ? a : b;
 }
 #endif
 
@@ -1531,88 +1787,30 @@ unsigned long long int doFactor(unsigned long long int n)
 {
 #ifndef TINY_BUILD
 	/* find the least prime factor of `n'.
-	* numbers up to 10^14 can be factored. worst case about 30 seconds
-	* on realbuild.
+	* small factors are found by trial division, the remainder is
+	* either proven prime or split by Pollard's rho.
 	*
 	* returns least prime factor or `n' if prime.
-	* returns 0 if failed to find factor.
-	*
-	* we will only fail if we have a 14 digit number with a factor > dmax (1e7).
-	* since we have a 12 digit display, this ought to be good, but actually more digits are
-	* held internally. for example 10000019*1000079 displays as scientific, but actually all
-	* the digits are held. this example will return 0.
+	* returns 0 if failed to find factor, which shouldn't happen.
 	*/
-
 	unsigned int d;
-	unsigned int dmax = 10000000; // biggest factor, 10^7
-	unsigned int rt;
-	unsigned int limit;
-
-	unsigned int ad[MAX_TERMS];
-	int nd;
-	int i, j;
-	unsigned char* cp;
+	int i;
 
-	// eliminate small cases < 257
-	if (n <= 2) return n;
+	if (n <= 3) return n;
 	if ((n & 1) == 0) return 2;
-	for (i=1; i<N_PRIMES; i++) {
-		if (n % primes[i] == 0)
-			return primes[i];
-	}
-	if (n <= QUICK_CHECK)		// the number is prime
-		return n;
-
-	rt = (unsigned int)intSqrt(n);
-	limit = rt;
-	if (limit > dmax)
-		limit = dmax; // max time about 30 seconds
-
-	// starting factor for search
-	d = 257;
-
-	// since we've eliminated all factors < 257, convert
-	// the initial number to bytes to get base 256
-	// XX ASSUME little endian here.
-	cp = (unsigned char*)&n;
-	nd = 0;
-	for (i = 0; i < sizeof(n); ++i)
-		if ((ad[i] = *cp++) != 0) ++nd;
-
-	// and slide to 257
-	for (i = nd-2; i >= 0; --i)
-	{
-		for (j = i; j < nd-1; ++j)
-		{
-			if ((ad[j] -= ad[j+1]) < 0)
-			{
-				ad[j] += d;
-				--ad[j+1];
-			}
-		}
-		if (!ad[j]) --nd;
-	}
-
-	if (ad[0])
-	{
-		// find factor or return 0 if limit reached
-		d = dscanOdd(d, limit, nd, ad);
-		if (!d)
-		{
-			// no factor found, if limit reached, we've failed
-			// otherwise `n' is prime
-			if (limit == dmax)
-			n = 0; // fail
-		}
+	if (n % 3 == 0) return 3;
+	if (n % 5 == 0) return 5;
+	for (d = 7, i = 0; d < FACTOR_TRIAL; d += factor_wheel[i], i = (i + 1) & 7) {
+		if ((unsigned long long int) d * d > n)
+			return n;
+		if (n % d == 0)
+			return d;
 	}
-
-	if (d) n = d;
-	return n;
+	return least_factor(n);
 #else
 	return 0;
 #endif
 }
-#undef MAX_TERMS
 
 
 long long int intFactor(long long int x) {
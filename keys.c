@@ -55,13 +55,13 @@ enum confirmations {
 	confirm_none=0, confirm_clall, confirm_reset, confirm_clprog, confirm_clpall
 };
 
-FLAG WasDataEntry;
+PER_INSTANCE FLAG WasDataEntry;
 
 /* Local data to this module */
-unsigned int OpCode;
-FLAG OpCodeDisplayPending;
-FLAG GoFast;
-FLAG NonProgrammable;
+PER_INSTANCE unsigned int OpCode;
+PER_INSTANCE FLAG OpCodeDisplayPending;
+PER_INSTANCE FLAG GoFast;
+PER_INSTANCE FLAG NonProgrammable;
 
 /*
  *  Needed before definition
@@ -429,6 +429,7 @@ void init_state(void) {
 	xset(&State2, 0, sizeof(State2));
 	State2.test = TST_NONE;
 	State2.runmode = 1;
+	invalidate_program_index(-1);
 	update_program_bounds(1);
 	set_lift();
 
@@ -2548,7 +2549,7 @@ static int process(const int c) {
  */
 void process_keycode(int c)
 {
-	static int was_paused;
+	static PER_INSTANCE int was_paused;
 	//volatile int cmdline_empty; // volatile because it's uninitialized in some cases
     int cmdline_empty = 0;        // Visual studio chokes in debug mode over the above
 
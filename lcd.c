@@ -27,7 +27,7 @@ volatile FLAG WaitForLcd;
 #endif
 
 #ifdef USECURSES
-static unsigned char dots[400];
+static PER_INSTANCE unsigned char dots[400];
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wformat"
 #pragma GCC diagnostic ignored "-Wformat-extra-args"
@@ -216,14 +216,18 @@ void reset_disp(void) {
 		if (i != RCL_annun && i != BATTERY && i != LIT_EQ )
 			clr_dot(i);
 
-	erase();
-        MOVE(0, 4);
+	if (! batch_mode) {
+		erase();
+		MOVE(0, 4);
+	}
 #else
-        putchar('\r');
-        for (i=0; i<70; i++)
-                putchar(' ');
-        putchar('\r');
-        putchar(' ');
+	if (! batch_mode) {
+		putchar('\r');
+		for (i=0; i<70; i++)
+			putchar(' ');
+		putchar('\r');
+		putchar(' ');
+	}
 #endif
 #endif
         State2.invalid_disp = 0;
@@ -353,7 +357,7 @@ void show_stack(void) {
 #ifdef USECURSES
         int i;
 
-        if (!State2.flags)
+        if (!State2.flags || batch_mode)
                 return;
 
         // Stack display smashes the stack registers
@@ -381,7 +385,7 @@ void show_flags(void) {
 #ifdef CONSOLE
 	extern unsigned int get_local_flags(void);
 
-	if (!State2.flags)
+	if (!State2.flags || batch_mode)
 		return;
 	MOVE(0, 0);
 	PRINTF(" %c ", JustDisplayed ? '*' : ' ');
@@ -518,6 +522,8 @@ void finish_display(void) {
 	}
 #else
 #ifdef USECURSES
+        if (batch_mode)
+                return;
         show_disp();
         MOVE(0, 0);
         refresh();
@@ -528,7 +534,8 @@ void finish_display(void) {
         void updateScreen();
         updateScreen();
 #else
-        putchar('\r');
+        if (! batch_mode)
+                putchar('\r');
 #endif
 #endif
 }
@@ -540,7 +547,7 @@ void finish_display(void) {
 extern const char *pretty(unsigned char);
 
 static char *cleanse(const char *s) {
-        static char res[50];
+        static PER_INSTANCE char res[50];
         char *p;
 
         for (p=res; *s != '\0'; s++) {
@@ -565,7 +572,7 @@ void show_progtrace(char *buf) {
 #ifdef USECURSES
         int i;
 
-        if (!State2.flags)
+        if (!State2.flags || batch_mode)
                 return;
 
         for (i=4; i>0 && pc >= 0; i--) {
@@ -578,6 +585,8 @@ void show_progtrace(char *buf) {
                 pc = do_dec(pc, 1);
         }
 #else
+        if (batch_mode)
+                return;
         if (pc) {
                 opcode op = getprog(pc);
                 PRINTF("%03u %08x: %s", pc, op, cleanse(prt(op, buf)));
@@ -21,6 +21,7 @@
 
 #define MAX_DIMENSION	100
 #define MAX_SQUARE	10
+#define MATRIX_TILE	4	/* Multiply in tiles this square, bounded by stack use */
 
 static int matrix_idx(int row, int col, int ncols) {
 	return col + row * ncols;
@@ -295,7 +296,8 @@ decNumber *matrix_getrc(decNumber *res, const decNumber *m) {
 // a = a + b * k -- generalised matrix add and subtract
 decNumber *matrix_genadd(decNumber *r, const decNumber *k, const decNumber *b, const decNumber *a) {
 	int arows, acols, brows, bcols;
-	decNumber s, t, u;
+	decNumber s;
+	decAccumulator acc;
 	int i;
 
 	decimal64 *abase = matrix_decomp(a, &arows, &acols);
@@ -307,24 +309,27 @@ decNumber *matrix_genadd(decNumber *r, const decNumber *k, const decNumber *b, c
 		return NULL;
 	}
 	for (i=0; i<arows*acols; i++) {
-		decimal64ToNumber(bbase + i, &s);
-		dn_multiply(&t, &s, k);
 		decimal64ToNumber(abase + i, &s);
-		dn_add(&u, &t, &s);
-		packed_from_number(abase + i, &u);
+		dn_acc_init(&acc, &s);
+		decimal64ToNumber(bbase + i, &s);
+		dn_acc_mac(&acc, &s, k);
+		packed_from_number(abase + i, &acc.n);
 	}
 	return decNumberCopy(r, a);
 }
 
 
 // Matrix multiply c = a * b, c can be a or b or overlap either
+// The product is built a tile at a time.  For each k the tile's elements of
+// column k of A and row k of B are unpacked once and used across the tile.
+// Every element is accumulated exactly and rounded once when packed.
 decNumber *matrix_multiply(decNumber *r, const decNumber *a, const decNumber *b, const decNumber *c) {
 	int arows, acols, brows, bcols;
-	decNumber sum, s, t, u;
+	decAccumulator sum[MATRIX_TILE][MATRIX_TILE];
+	decNumber s[MATRIX_TILE], t[MATRIX_TILE];
 	int creg;
-	int i, j, k;
+	int i, j, k, i0, j0, ni, nj;
 	decimal64 result[MAX_DIMENSION];
-	decimal64 *rp = result;
 	decimal64 *abase = matrix_decomp(a, &arows, &acols);
 	decimal64 *bbase = matrix_decomp(b, &brows, &bcols);
 
@@ -339,17 +344,27 @@ decNumber *matrix_multiply(decNumber *r, const decNumber *a, const decNumber *b,
 		return NULL;
 
         busy();
-	for (i=0; i<arows; i++)
-		for (j=0; j<bcols; j++) {
-			decNumberZero(&sum);
+	for (i0=0; i0<arows; i0 += MATRIX_TILE) {
+		ni = arows - i0 < MATRIX_TILE ? arows - i0 : MATRIX_TILE;
+		for (j0=0; j0<bcols; j0 += MATRIX_TILE) {
+			nj = bcols - j0 < MATRIX_TILE ? bcols - j0 : MATRIX_TILE;
+			for (i=0; i<ni; i++)
+				for (j=0; j<nj; j++)
+					dn_acc_init(&sum[i][j], NULL);
 			for (k=0; k<acols; k++) {
-				matrix_get(&s, abase, i, k, acols);
-				matrix_get(&t, bbase, k, j, bcols);
-				dn_multiply(&u, &s, &t);
-				dn_add(&sum, &sum, &u);
+				for (i=0; i<ni; i++)
+					matrix_get(&s[i], abase, i0 + i, k, acols);
+				for (j=0; j<nj; j++)
+					matrix_get(&t[j], bbase, k, j0 + j, bcols);
+				for (i=0; i<ni; i++)
+					for (j=0; j<nj; j++)
+						dn_acc_mac(&sum[i][j], &s[i], &t[j]);
 			}
-			packed_from_number(rp++, &sum);
+			for (i=0; i<ni; i++)
+				for (j=0; j<nj; j++)
+					packed_from_number(result + matrix_idx(i0 + i, j0 + j, bcols), &sum[i][j].n);
 		}
+	}
 	xcopy(get_reg_n(creg), result, sizeof(decimal64) * arows * bcols);
 	return r;
 }
@@ -391,6 +406,7 @@ decNumber *matrix_transpose(decNumber *r, const decNumber *m) {
 #ifdef MATRIX_ROWOPS
 void matrix_rowops(enum nilop op) {
 	decNumber m, ydn, zdn, t;
+	decAccumulator acc;
 	decimal64 *base, *r1, *r2;
 	int rows, cols;
 	int i;
@@ -425,10 +441,10 @@ badrow:		err(ERR_RANGE);
 		} else {
 			for (i=0; i<cols; i++) {
 				decimal64ToNumber(r1, &ydn);
+				dn_acc_init(&acc, &ydn);
 				decimal64ToNumber(r2++, &zdn);
-				dn_multiply(&m, &zdn, &t);
-				dn_add(&zdn, &ydn, &m);
-				packed_from_number(r1++, &zdn);
+				dn_acc_mac(&acc, &zdn, &t);
+				packed_from_number(r1++, &acc.n);
 			}
 		}
 	}
@@ -451,7 +467,27 @@ static void matrix_put128(const decNumber *x, decimal128 *base, int row, int col
 /* Perform a LU decomposition of the specified matrix in-situ.
  * Return the pivot rows in pivots if not null and return the parity
  * of the number of pivots or zero if the matrix is singular
+ *
+ * This is Crout's ordering of Doolittle's method: each element of L and U
+ * is a single dot product accumulated exactly and rounded once, rather
+ * than being updated and rounded at every step.  The pivot choice is the
+ * same as for the usual row by row elimination.
  */
+static void LU_element(decimal128 *A, int i, int j, int m, const int n) {
+	decNumber t, u;
+	decAccumulator acc;
+	int k;
+
+	matrix_get128(&t, A, i, j, n);
+	dn_acc_init(&acc, &t);
+	for (k=0; k<m; k++) {
+		matrix_get128(&t, A, i, k, n);
+		matrix_get128(&u, A, k, j, n);
+		dn_acc_msc(&acc, &t, &u);
+	}
+	packed128_from_number(A + matrix_idx(i, j, n), &acc.n);
+}
+
 static int LU_decomposition(decimal128 *A, unsigned char *pivots, const int n) {
 	int i, j, k;
 	int pvt, spvt = 1;
@@ -460,6 +496,10 @@ static int LU_decomposition(decimal128 *A, unsigned char *pivots, const int n) {
 
         busy();
 	for (k=0; k<n; k++) {
+		/* Finish column k of the remaining rows */
+		for (j=k; j<n; j++)
+			LU_element(A, j, k, k, n);
+
 		/* Find the pivot row */
 		pvt = k;
 		matrix_get128(&u, A, k, k, n);
@@ -497,21 +537,13 @@ static int LU_decomposition(decimal128 *A, unsigned char *pivots, const int n) {
 
 		/* Find the lower triangular elements for column k */
 		for (i=k+1; i<n; i++) {
-			matrix_get128(&t, A, k, k, n);
 			matrix_get128(&u, A, i, k, n);
 			dn_divide(&max, &u, &t);
 			matrix_put128(&max, A, i, k, n);
 		}
-		/* Update the upper triangular elements */
-		for (i=k+1; i<n; i++)
-			for (j=k+1; j<n; j++) {
-				matrix_get128(&t, A, i, k, n);
-				matrix_get128(&u, A, k, j, n);
-				dn_multiply(&max, &t, &u);
-				matrix_get128(&t, A, i, j, n);
-				dn_subtract(&u, &t, &max);
-				matrix_put128(&u, A, i, j, n);
-			}
+		/* and the upper triangular elements for row k */
+		for (j=k+1; j<n; j++)
+			LU_element(A, k, j, k, n);
 	}
 	return spvt;
 }
@@ -524,7 +556,8 @@ static int LU_decomposition(decimal128 *A, unsigned char *pivots, const int n) {
  */
 static void matrix_pivoting_solve(decimal128 *LU, const decimal64 *b[], unsigned char pivot[], decNumber *x, int n) {
 	int i, k;
-	decNumber r, t;
+	decNumber r;
+	decAccumulator acc;
 
 	/* Solve the first linear equation Ly = b */
 	for (k=0; k<n; k++) {
@@ -534,21 +567,23 @@ static void matrix_pivoting_solve(decimal128 *LU, const decimal64 *b[], unsigned
 			b[pivot[k]] = swap;
 		}
 		decimal64ToNumber(b[k], x + k);
+		dn_acc_init(&acc, x + k);
 		for (i=0; i<k; i++) {
 			matrix_get128(&r, LU, k, i, n);
-			dn_multiply(&t, &r, x+i);
-			dn_subtract(x+k, x+k, &t);
+			dn_acc_msc(&acc, &r, x+i);
 		}
+		dn_acc_round(x+k, &acc);
 	}
 
 	/* Solve the second linear equation Ux = y */
 	for (k=n-1; k>=0; k--) {
 		//if(k != pivot[k]) swap(b[k], b[pivot[k]]);		// undo pivoting from before
+		dn_acc_init(&acc, x + k);
 		for (i=k+1; i<n; i++) {
 			matrix_get128(&r, LU, k, i, n);
-			dn_multiply(&t, &r, x+i);
-			dn_subtract(x+k, x+k, &t);
+			dn_acc_msc(&acc, &r, x+i);
 		}
+		dn_acc_round(x+k, &acc);
 		matrix_get128(&r, LU, k, k, n);
 #if 0
 		/* Check for singular matrix */
@@ -721,4 +756,60 @@ decNumber *matrix_lu_decomp(decNumber *r, const decNumber *m) {
 	}
 	return r;
 }
+
+/* Solve LU x = b given the decomposition and pivot descriptor from M.LU.
+ * The solution overwrites b.  Reusing the decomposition makes each solve
+ * O(n^2) rather than the O(n^3) LINEQS needs.
+ */
+decNumber *matrix_lu_solve(decNumber *r, const decNumber *lu, const decNumber *p, const decNumber *b) {
+	unsigned char pivots[MAX_SQUARE];
+	decimal128 mat[MAX_SQUARE*MAX_SQUARE];
+	decNumber x[MAX_SQUARE], t, u;
+	const decimal64 *bv[MAX_SQUARE];
+	decimal64 *bbase;
+	int i, n, brows, bcols;
+
+	n = matrix_lu_check(lu, mat, NULL);
+	if (n == 0)
+		return NULL;
+
+	bbase = matrix_decomp(b, &brows, &bcols);
+	if (bbase == NULL)
+		return NULL;
+	if (brows != n || bcols != 1) {
+		err(ERR_MATRIX_DIM);
+		return NULL;
+	}
+
+	/* Unpack the pivot descriptor, the last pivot is the units digit */
+	if (decNumberIsSpecial(p) || dn_lt0(p) || ! is_int(p))
+		goto bad;
+	decNumberCopy(&t, p);
+	for (i=n-1; i>=0; i--) {
+		decNumberMod(&u, &t, &const_10);
+		pivots[i] = dn_to_int(&u);
+		if (pivots[i] < i || pivots[i] >= n)
+			goto bad;
+		dn_divide(&u, &t, &const_10);
+		decNumberTrunc(&t, &u);
+	}
+	if (! dn_eq0(&t))
+		goto bad;
+
+	for (i=0; i<n; i++) {
+		matrix_get128(&t, mat, i, i, n);
+		if (dn_eq0(&t)) {
+			err(ERR_SINGULAR);
+			return NULL;
+		}
+		bv[i] = bbase + i;
+	}
+	matrix_pivoting_solve(mat, bv, pivots, x, n);
+	for (i=0; i<n; i++)
+		packed_from_number(bbase+i, x+i);
+	return decNumberCopy(r, b);
+
+bad:	err(ERR_BAD_PARAM);
+	return NULL;
+}
 #endif
@@ -37,6 +37,7 @@ extern decNumber *matrix_copy(decNumber *r, const decNumber *y, const decNumber
 
 extern decNumber *matrix_determinant(decNumber *r, const decNumber *x);
 extern decNumber *matrix_lu_decomp(decNumber *r, const decNumber *x);
+extern decNumber *matrix_lu_solve(decNumber *r, const decNumber *lu, const decNumber *p, const decNumber *b);
 extern void matrix_inverse(enum nilop op);
 extern decNumber *matrix_linear_eqn(decNumber *r, const decNumber *a, const decNumber *b, const decNumber *c);
 
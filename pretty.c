@@ -620,7 +620,10 @@ void dump_opcodes(FILE *f, int xref) {
 					continue;
 				}
 				if (d == OP_LOADA2D || d == OP_SAVEA2D ||
-						d == OP_GSBuser || d == OP_POPUSR) {
+						d == OP_GSBuser || d == OP_POPUSR ||
+						d == OP_SLVI || d == OP_SLVS ||
+						d == OP_INTI || d == OP_INTS ||
+						d == OP_SUMS || d == OP_PRDS) {
 					dump_one_opcode(f, c, cn, E_CMD_CMD, cmdpretty, E_ALIAS, CNULL, E_ATTR_XROM, xref);
 					continue;
 				}
@@ -29,7 +29,7 @@
  *  Where will the next data be printed?
  *  Columns are in pixel units from 0 to 165
  */
-unsigned int PrinterColumn;
+PER_INSTANCE unsigned int PrinterColumn;
 
 /*
  *  Print to IR or serial port, depending on the PMODE setting
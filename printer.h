@@ -57,7 +57,7 @@ extern int put_ir( int byte );
 #define PRINT_DELAY 18	// 1.8 seconds
 extern volatile SMALL_INT PrintDelay;
 #endif
-extern unsigned int PrinterColumn;
+extern PER_INSTANCE unsigned int PrinterColumn;
 
 #ifndef INFRARED
 #define print_trace( op, phase ) /**/
@@ -52,9 +52,9 @@ extern void serial_unlock(void);
 /*
  *  Flags and hardware buffer for received data
  */
-volatile short InBuffer[ IN_BUFF_LEN ];
-volatile char InRead, InWrite, InCount;
-char SerialOn;
+PER_INSTANCE volatile short InBuffer[ IN_BUFF_LEN ];
+PER_INSTANCE volatile char InRead, InWrite, InCount;
+PER_INSTANCE char SerialOn;
 
 /*
  *  Handle the flag and the annunciator
@@ -436,6 +436,7 @@ void recv_any( enum nilop op )
 		 *  Copy the data and recompute the checksums
 		 */
 		xcopy( dest, buffer, length );
+		invalidate_program_index( -1 );
 	done:
 		checksum_all();
 
@@ -0,0 +1,795 @@
+/* This file is part of 34S.
+ * 
+ * 34S is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * 34S is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with 34S.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solve.h"
+#include "decn.h"
+#include "consts.h"
+
+/* The solver behind SLV.
+ *
+ * XROM calls the user's function and passes each value to SLVS which does
+ * the bookkeeping and leaves the next estimate in X, SLVI starts the search
+ * from the two initial guesses.  The state is kept in the local registers
+ * and flags of the XROM frame so a solve inside a solve keeps its own.  The
+ * methods are those the keystroke version used: Ridders' method after a
+ * bisection, else inverse quadratic interpolation falling back to a secant
+ * step, a bisection when the estimate leaves the bracket and a widening
+ * search while the function is one sided or constant.
+ */
+#define SLV_A		(LOCAL_REG_BASE + 0)	// lower bound
+#define SLV_B		(LOCAL_REG_BASE + 1)	// upper bound
+#define SLV_C		(LOCAL_REG_BASE + 2)	// last estimate
+#define SLV_FA		(LOCAL_REG_BASE + 3)
+#define SLV_FB		(LOCAL_REG_BASE + 4)
+#define SLV_COUNT	(LOCAL_REG_BASE + 5)
+
+#define SLV_BRACKET	(LOCAL_FLAG_BASE + 0)	// a and b bracket a solution
+#define SLV_CONST	(LOCAL_FLAG_BASE + 1)	// the function looks constant
+#define SLV_RIDDERS	(LOCAL_FLAG_BASE + 2)	// a Ridders' step is possible
+#define SLV_FAILED	(LOCAL_FLAG_BASE + 3)	// set when SLVS gives up
+
+#define BRACKET_MAXCOUNT	250
+#define CONST_MAXCOUNT		20
+#define ONESIDE_MAXCOUNT	100
+
+struct solver_state {
+	decNumber a, b, c, fa, fb, fc;
+};
+
+static void solver_secant(decNumber *r, const struct solver_state *s) {
+	decNumber x, y, z;
+
+	dn_subtract(&x, &s->b, &s->a);
+	dn_subtract(&y, &s->fb, &s->fa);
+	dn_divide(&z, &x, &y);
+	dn_multiply(&y, &z, &s->fb);
+	dn_subtract(r, &s->b, &y);
+}
+
+/* One term x f2 f3 / ((f2 - f1) (f3 - f1)) of the inverse quadratic
+ * interpolation, non-zero if a denominator vanishes.
+ */
+static int solver_qterm(decNumber *r, const decNumber *x, const decNumber *f1, const decNumber *f2, const decNumber *f3) {
+	decNumber s, t, u;
+
+	dn_subtract(&s, f2, f1);
+	dn_subtract(&t, f3, f1);
+	dn_multiply(&u, &s, &t);
+	if (dn_eq0(&u))
+		return -1;
+	dn_divide(&s, x, &u);
+	dn_multiply(&t, f2, f3);
+	dn_multiply(r, &s, &t);
+	return 0;
+}
+
+static int solver_quadratic(decNumber *r, const struct solver_state *s) {
+	decNumber t, u;
+
+	if (solver_qterm(&t, &s->a, &s->fa, &s->fb, &s->fc))
+		return -1;
+	if (solver_qterm(&u, &s->b, &s->fb, &s->fa, &s->fc))
+		return -1;
+	dn_add(r, &t, &u);
+	if (solver_qterm(&t, &s->c, &s->fc, &s->fa, &s->fb))
+		return -1;
+	dn_add(r, r, &t);
+	return 0;
+}
+
+#ifdef USE_RIDDERS
+/* Ridders' method, non-zero if fc^2 - fa fb isn't positive */
+static int solver_ridders(decNumber *r, const struct solver_state *s) {
+	decNumber t, u, v;
+
+	decNumberSquare(&t, &s->fc);
+	dn_multiply(&u, &s->fa, &s->fb);
+	dn_subtract(&v, &t, &u);
+	if (dn_le0(&v))
+		return -1;
+	dn_sqrt(&t, &v);
+	dn_divide(&u, &s->fc, &t);
+	if (dn_eq(&s->fa, &s->fb))
+		decNumberZero(&u);
+	else if (dn_lt(&s->fa, &s->fb))
+		dn_minus(&u, &u);
+	dn_subtract(&t, &s->c, &s->a);
+	dn_multiply(&v, &t, &u);
+	dn_add(r, &v, &s->c);
+	return 0;
+}
+#endif
+
+static void solver_bisect(decNumber *r, const struct solver_state *s) {
+	dn_average(r, &s->a, &s->b);
+#ifdef USE_RIDDERS
+	set_user_flag(SLV_RIDDERS);
+#endif
+}
+
+/* Is x strictly between a and b? */
+static int solver_inside(const decNumber *x, const decNumber *a, const decNumber *b) {
+	decNumber lo, hi;
+
+	dn_min(&lo, a, b);
+	dn_max(&hi, a, b);
+	return dn_lt(&lo, x) && dn_lt(x, &hi);
+}
+
+static void solver_swap(decNumber *a, decNumber *b) {
+	decNumber t;
+
+	decNumberCopy(&t, a);
+	decNumberCopy(a, b);
+	decNumberCopy(b, &t);
+}
+
+static void solver_push(const decNumber *x) {
+	lift();
+	setX(x);
+}
+
+static void solver_step(enum nilop op) {
+	struct solver_state s;
+	decNumber est, t, u;
+	int count, secant;
+
+	getRegister(&s.a, SLV_A);
+	getRegister(&s.b, SLV_B);
+	getRegister(&s.c, SLV_C);
+	getRegister(&s.fa, SLV_FA);
+	getRegister(&s.fb, SLV_FB);
+	getRegister(&t, SLV_COUNT);
+	count = dn_to_int(&t);
+
+	if (op == OP_SLVI) {
+		dn_multiply(&t, &s.fa, &s.fb);
+		if (dn_ge0(&t)) {
+			if (dn_eq(&s.fa, &s.fb))
+				set_user_flag(SLV_CONST);
+			solver_bisect(&est, &s);
+		} else {
+			set_user_flag(SLV_BRACKET);
+			solver_secant(&est, &s);
+			if (! solver_inside(&est, &s.a, &s.b))
+				solver_bisect(&est, &s);
+		}
+		setRegister(SLV_C, &est);
+		setX(&est);
+		return;
+	}
+
+	getX(&s.fc);
+	count++;
+	if (! get_user_flag(SLV_BRACKET)) {
+		if (decNumberIsNegative(&s.fc) != decNumberIsNegative(&s.fb)) {
+			count = 0;
+			set_user_flag(SLV_BRACKET);
+			goto bracket;
+		}
+		if (get_user_flag(SLV_CONST)) {
+			if (count > CONST_MAXCOUNT)
+				goto failed;
+			if (! dn_eq(&s.fc, &s.fb)) {
+				count = 0;
+				clr_user_flag(SLV_CONST);
+				goto one_sided;
+			}
+			// Still constant: widen the interval alternately at either end
+			if (count & 1) {
+				decNumberCopy(&s.b, &s.c);
+				decNumberCopy(&s.fb, &s.fc);
+				if (decNumberIsNegative(&s.a))
+					dn_mul2(&t, &s.a);
+				else
+					dn_div2(&t, &s.a);
+				dn_subtract(&est, &t, &const_10);
+			} else {
+				decNumberCopy(&s.a, &s.c);
+				decNumberCopy(&s.fa, &s.fc);
+				if (decNumberIsNegative(&s.b))
+					dn_div2(&t, &s.b);
+				else
+					dn_mul2(&t, &s.b);
+				dn_add(&est, &t, &const_10);
+			}
+			goto estimate;
+		}
+		if (count > ONESIDE_MAXCOUNT)
+			goto failed;
+one_sided:
+		secant = solver_quadratic(&est, &s);
+		if (dn_abs_lt(&s.fb, dn_abs(&t, &s.fa))) {
+			decNumberCopy(&s.b, &s.c);
+			decNumberCopy(&s.fb, &s.fc);
+		} else {
+			decNumberCopy(&s.a, &s.c);
+			decNumberCopy(&s.fa, &s.fc);
+		}
+		if (dn_lt(&s.b, &s.a)) {
+			solver_swap(&s.a, &s.b);
+			solver_swap(&s.fa, &s.fb);
+		}
+		if (secant)
+			solver_secant(&est, &s);
+
+		// Stay within 100 times the width of the interval
+		dn_subtract(&t, &s.b, &s.a);
+		dn_abs(&u, &t);
+		dn_mul100(&t, &u);
+		dn_subtract(&u, &s.a, &t);
+		if (dn_ge(&u, &est))
+			decNumberCopy(&est, &u);
+		else {
+			dn_add(&u, &s.b, &t);
+			if (dn_le(&u, &est))
+				decNumberCopy(&est, &u);
+		}
+		goto estimate;
+	}
+	if (count > BRACKET_MAXCOUNT)
+		goto failed;
+
+bracket:
+	secant = 0;
+#ifdef USE_RIDDERS
+	if (! get_user_flag(SLV_RIDDERS) || solver_ridders(&est, &s))
+#endif
+		secant = solver_quadratic(&est, &s);
+	clr_user_flag(SLV_RIDDERS);
+	if (decNumberIsNegative(&s.fc) != decNumberIsNegative(&s.fb)) {
+		decNumberCopy(&s.a, &s.c);
+		decNumberCopy(&s.fa, &s.fc);
+		decNumberCopy(&u, &s.b);
+	} else {
+		decNumberCopy(&s.b, &s.c);
+		decNumberCopy(&s.fb, &s.fc);
+		decNumberCopy(&u, &s.a);
+	}
+	if (secant)
+		solver_secant(&est, &s);
+	if (! solver_inside(&est, &u, &s.c))
+		solver_bisect(&est, &s);
+
+estimate:
+	setRegister(SLV_A, &s.a);
+	setRegister(SLV_B, &s.b);
+	setRegister(SLV_C, &est);
+	setRegister(SLV_FA, &s.fa);
+	setRegister(SLV_FB, &s.fb);
+	int_to_dn(&t, count);
+	setRegister(SLV_COUNT, &t);
+
+	// Carry on until a and b are within 5 ULP of each other
+	dn_abs(&t, &s.a);
+	dn_abs(&u, &s.b);
+	dn_min(&t, &t, &u);
+	decNumberULP(&u, &t);
+	dn_multiply(&t, &u, &const_5);
+	dn_subtract(&u, &s.b, &s.a);
+	dn_abs(&u, &u);
+	if (dn_le(&t, &u)) {
+		setX(&est);
+		fin_tst(1);
+		return;
+	}
+	setRegister(regL_idx, &const_0);
+	decNumberCopy(&u, &s.b);
+	goto finish;
+
+failed:
+	set_user_flag(SLV_FAILED);
+	setRegister(regL_idx, &s.fc);
+	decNumberCopy(&est, &s.c);
+	if (dn_abs_lt(&s.fb, dn_abs(&t, &s.fa)))
+		decNumberCopy(&u, &s.b);
+	else
+		decNumberCopy(&u, &s.a);
+
+finish:
+	// X = estimate, Y = the other end, Z = f(c), T = 0
+	solver_push(&const_0);
+	solver_push(&s.fc);
+	solver_push(&u);
+	solver_push(&est);
+	fin_tst(0);
+}
+
+/* The arithmetic is carried out at register precision as it was in XROM,
+ * the one sided search relies on the rounding to step over a root it is
+ * approaching from one side and an estimate which only differs from an end
+ * point in the guard digits would otherwise be taken as inside the bracket.
+ */
+void solver(enum nilop op) {
+	const int digits = Ctx.digits;
+
+	Ctx.digits = is_dblmode() ? 34 : 16;
+	solver_step(op);
+	Ctx.digits = digits;
+}
+
+/* The double exponential integrator behind INTEGRATE.
+ *
+ * XROM calls the user's function and passes each value to INTS, INTI sets
+ * things up from the limits.  INTS leaves the next abscissa in X and
+ * carries on, at the end of a level it skips with the approximation in X
+ * and the next abscissa in Y, and once the result is known it skips with
+ * the result in X and Y and the error estimate in Z and sets the done flag.
+ * The algorithm and its parameters are those of the keystroke version by
+ * M. Cesar Rodriguez, see xrom/integrate.wp34s.
+ */
+#define DE_B		(LOCAL_REG_BASE + 0)	// upper limit
+#define DE_A		(LOCAL_REG_BASE + 1)	// lower limit
+#define DE_BMA2		(LOCAL_REG_BASE + 2)	// (b - a) / 2
+#define DE_BPA2		(LOCAL_REG_BASE + 3)	// (b + a) / 2
+#define DE_EPS		(LOCAL_REG_BASE + 4)
+#define DE_THR		(LOCAL_REG_BASE + 5)	// convergence threshold
+#define DE_LVL		(LOCAL_REG_BASE + 6)	// levels left
+#define DE_TM		(LOCAL_REG_BASE + 7)	// largest t
+#define DE_H		(LOCAL_REG_BASE + 8)	// step in t
+#define DE_SSP		(LOCAL_REG_BASE + 9)	// sum for this level
+#define DE_J		(LOCAL_REG_BASE + 10)	// t = j h
+#define DE_CH		(LOCAL_REG_BASE + 11)	// cosh t
+#define DE_W		(LOCAL_REG_BASE + 12)	// weight
+#define DE_FP		(LOCAL_REG_BASE + 13)	// weighted f at the first abscissa
+#define DE_SS		(LOCAL_REG_BASE + 14)	// sum over all levels
+#define DE_SS1		(LOCAL_REG_BASE + 15)	// previous approximation
+#define DE_R		(LOCAL_REG_BASE + 16)	// normalised abscissa
+#define DE_K		(LOCAL_REG_BASE + 17)	// level
+
+#define DE_REV		(LOCAL_FLAG_BASE + 1)	// b < a
+#define DE_ES		(LOCAL_FLAG_BASE + 2)	// exp-sinh, one limit infinite
+#define DE_LEFT		(LOCAL_FLAG_BASE + 4)	// exp-sinh to -infinity
+#define DE_TS		(LOCAL_FLAG_BASE + 5)	// tanh-sinh, both limits finite
+#define DE_LG0		(LOCAL_FLAG_BASE + 6)	// past level 0
+#define DE_MINUS	(LOCAL_FLAG_BASE + 7)	// waiting for the second abscissa
+#define DE_CENTRE	(LOCAL_FLAG_BASE + 8)	// waiting for the centre point
+#define DE_DONE		(LOCAL_FLAG_BASE + 9)	// result on the stack
+
+enum de_kind {
+	DE_TANH_SINH = 1, DE_EXP_SINH, DE_SINH_SINH
+};
+
+struct de_state {
+	decNumber bma2, bpa2, h, ssp, ch, w, fp, ss, ss1, r;
+	enum de_kind kind;
+	int j, k;
+};
+
+/* Abscissa and weight for t in the normalised domain, rounded to register
+ * precision so cached and freshly computed values agree.
+ */
+static void de_weights(decNumber *ch, decNumber *w, decNumber *r, const decNumber *t, enum de_kind kind) {
+	const int digits = Ctx.digits;
+	int digits_reg;
+	decNumber s, u, v;
+
+	Ctx.digits = DECNUMDIGITS;
+	dn_sinhcosh(t, &u, ch);
+	dn_multiply(&s, &u, &const_PIon2);
+	if (kind == DE_EXP_SINH) {
+		dn_exp(w, &s);
+		decNumberCopy(r, w);
+	} else if (kind == DE_SINH_SINH)
+		dn_sinhcosh(&s, r, w);
+	else {
+		dn_sinhcosh(&s, &u, &v);
+		dn_divide(r, &u, &v);
+		decNumberSquare(&u, &v);
+		decNumberRecip(w, &u);
+	}
+	Ctx.digits = digits;
+	digits_reg = is_dblmode() ? 34 : 16;
+	decNumberRoundDigits(ch, ch, digits_reg, DEC_ROUND_HALF_EVEN);
+	decNumberRoundDigits(w, w, digits_reg, DEC_ROUND_HALF_EVEN);
+	decNumberRoundDigits(r, r, digits_reg, DEC_ROUND_HALF_EVEN);
+}
+
+#ifdef INCLUDE_INTEGRATE_CACHE
+/* The abscissae and weights are the same for every integral of a kind, so
+ * each precision keeps those of the last kind used for t on a grid of
+ * 2^-DE_CACHE_LEVEL.  Finer levels and larger t are computed every time.
+ */
+#define DE_CACHE_LEVEL	7
+#define DE_CACHE_SIZE	(10 << DE_CACHE_LEVEL)
+
+static PER_INSTANCE struct {
+	unsigned char kind;		// zero if empty
+	unsigned char known[DE_CACHE_SIZE / 8];
+	struct {
+		decimal128 ch, w, r;
+	} point[DE_CACHE_SIZE];
+} DECache[2];
+
+static void de_cached_weights(struct de_state *s, const decNumber *t) {
+	const int shift = DE_CACHE_LEVEL - s->k;
+	const int i = s->j << (shift < 0 ? 0 : shift);
+	const int dbl = is_dblmode();
+
+	if (shift < 0 || i >= DE_CACHE_SIZE) {
+		de_weights(&s->ch, &s->w, &s->r, t, s->kind);
+		return;
+	}
+	if (DECache[dbl].kind != s->kind) {
+		xset(DECache[dbl].known, 0, sizeof(DECache[dbl].known));
+		DECache[dbl].kind = s->kind;
+	}
+	if (DECache[dbl].known[i >> 3] & (1 << (i & 7))) {
+		decimal128ToNumber(&DECache[dbl].point[i].ch, &s->ch);
+		decimal128ToNumber(&DECache[dbl].point[i].w, &s->w);
+		decimal128ToNumber(&DECache[dbl].point[i].r, &s->r);
+		return;
+	}
+	de_weights(&s->ch, &s->w, &s->r, t, s->kind);
+	packed128_from_number(&DECache[dbl].point[i].ch, &s->ch);
+	packed128_from_number(&DECache[dbl].point[i].w, &s->w);
+	packed128_from_number(&DECache[dbl].point[i].r, &s->r);
+	DECache[dbl].known[i >> 3] |= 1 << (i & 7);
+}
+#endif
+
+/* Move on to t = j h and put the first abscissa into x */
+static void de_point(decNumber *x, struct de_state *s) {
+	decNumber t, u;
+
+	int_to_dn(&u, s->j);
+	dn_multiply(&t, &u, &s->h);
+#ifdef INCLUDE_INTEGRATE_CACHE
+	de_cached_weights(s, &t);
+#else
+	de_weights(&s->ch, &s->w, &s->r, &t, s->kind);
+#endif
+	if (get_user_flag(DE_LEFT))
+		dn_minus(&s->r, &s->r);
+	dn_multiply(&u, &s->r, &s->bma2);
+	dn_add(x, &u, &s->bpa2);
+}
+
+static void de_load(struct de_state *s) {
+	decNumber t;
+
+	getRegister(&s->bma2, DE_BMA2);
+	getRegister(&s->bpa2, DE_BPA2);
+	getRegister(&s->h, DE_H);
+	getRegister(&s->ssp, DE_SSP);
+	getRegister(&s->ch, DE_CH);
+	getRegister(&s->w, DE_W);
+	getRegister(&s->fp, DE_FP);
+	getRegister(&s->ss, DE_SS);
+	getRegister(&s->ss1, DE_SS1);
+	getRegister(&s->r, DE_R);
+	getRegister(&t, DE_J);
+	s->j = dn_to_int(&t);
+	getRegister(&t, DE_K);
+	s->k = dn_to_int(&t);
+	s->kind = get_user_flag(DE_TS) ? DE_TANH_SINH : get_user_flag(DE_ES) ? DE_EXP_SINH : DE_SINH_SINH;
+}
+
+static void de_save(const struct de_state *s) {
+	decNumber t;
+
+	setRegister(DE_BMA2, &s->bma2);
+	setRegister(DE_BPA2, &s->bpa2);
+	setRegister(DE_H, &s->h);
+	setRegister(DE_SSP, &s->ssp);
+	setRegister(DE_CH, &s->ch);
+	setRegister(DE_W, &s->w);
+	setRegister(DE_FP, &s->fp);
+	setRegister(DE_SS, &s->ss);
+	setRegister(DE_SS1, &s->ss1);
+	setRegister(DE_R, &s->r);
+	int_to_dn(&t, s->j);
+	setRegister(DE_J, &t);
+	int_to_dn(&t, s->k);
+	setRegister(DE_K, &t);
+}
+
+enum de_result {
+	DE_CALL, DE_LEVEL, DE_FINISHED
+};
+
+/* Take the function value at the last abscissa.  Return DE_CALL with the
+ * next abscissa in x, DE_LEVEL with the next abscissa in x and the latest
+ * approximation in res or DE_FINISHED with the result in res and the error
+ * estimate in x.
+ */
+static enum de_result de_step(decNumber *x, decNumber *res, struct de_state *s, const decNumber *f) {
+	decNumber p, t, u;
+	int k;
+
+	if (get_user_flag(DE_CENTRE)) {
+		clr_user_flag(DE_CENTRE);
+		dn_add(&s->ss, &s->ss, f);
+		goto converge;
+	}
+	if (! get_user_flag(DE_MINUS)) {
+		dn_multiply(&s->fp, f, &s->w);
+		set_user_flag(DE_MINUS);
+		if (s->kind == DE_EXP_SINH) {
+			dn_divide(&t, &s->bma2, &s->r);
+			dn_add(x, &s->bpa2, &t);
+		} else {
+			dn_multiply(&t, &s->bma2, &s->r);
+			dn_subtract(x, &s->bpa2, &t);
+		}
+		return DE_CALL;
+	}
+	clr_user_flag(DE_MINUS);
+	if (s->kind == DE_EXP_SINH)
+		dn_divide(&t, f, &s->w);
+	else
+		dn_multiply(&t, f, &s->w);
+	dn_add(&u, &t, &s->fp);
+	dn_multiply(&p, &u, &s->ch);
+	if (decNumberIsSpecial(&p))
+		decNumberZero(&p);
+	dn_add(&s->ssp, &s->ssp, &p);
+
+	if (get_user_flag(DE_LG0)) {
+		// Only the odd abscissae are new, stop once the terms are negligible
+		s->j++;
+		getRegister(&u, DE_EPS);
+		dn_multiply(&t, &s->ssp, &u);
+		if (! dn_abs_lt(&t, dn_abs(&u, &p)))
+			goto level_end;
+		if (LastKey != 0) {
+			k = LastKey - 1;
+			LastKey = 0;
+			if (keycode_to_row_column(k) == 35) {
+				decNumberCopy(res, &s->ss1);
+				goto finish;
+			}
+		}
+	}
+	s->j++;
+	int_to_dn(&u, s->j);
+	dn_multiply(&t, &u, &s->h);
+	getRegister(&u, DE_TM);
+	if (dn_le(&t, &u)) {
+		de_point(x, s);
+		return DE_CALL;
+	}
+
+level_end:
+	dn_add(&s->ss, &s->ss, &s->ssp);
+	if (! get_user_flag(DE_LG0)) {
+		// Level 0 includes the centre point
+		set_user_flag(DE_CENTRE);
+		if (s->kind != DE_EXP_SINH)
+			decNumberCopy(x, &s->bpa2);
+		else if (get_user_flag(DE_LEFT))
+			dn_m1(x, &s->bpa2);
+		else
+			dn_p1(x, &s->bpa2);
+		return DE_CALL;
+	}
+
+converge:
+	dn_multiply(&t, &s->ss, &s->bma2);
+	dn_multiply(&u, &t, &s->h);
+	dn_multiply(res, &u, &const_PIon2);
+	if (get_user_flag(DE_REV))
+		dn_minus(res, res);
+
+	dn_mul2(&t, &s->ssp);
+	dn_subtract(&u, &t, &s->ss);
+	getRegister(&t, DE_THR);
+	dn_multiply(&p, &t, &s->ss);
+	if (dn_abs_lt(&u, dn_abs(&t, &p)))
+		goto finish;
+	set_user_flag(DE_LG0);
+	getRegister(&t, DE_LVL);
+	dn_dec(&t);
+	if (decNumberIsNegative(&t))
+		goto finish;
+	setRegister(DE_LVL, &t);
+
+	decNumberCopy(&s->ss1, res);
+	decNumberZero(&s->ssp);
+	dn_div2(&s->h, &s->h);
+	s->j = 1;
+	s->k++;
+	de_point(x, s);
+	return DE_LEVEL;
+
+finish:
+	// A large error means the result is lost in the rounding, usually an
+	// integral of zero
+	dn_subtract(&t, res, &s->ss1);
+	dn_abs(x, &t);
+	dn_mulpow10(&t, x, 1);
+	if (! dn_abs_lt(&t, dn_abs(&u, res))) {
+		dn_add(x, x, &u);
+		decNumberZero(res);
+	}
+	set_user_flag(DE_DONE);
+	return DE_FINISHED;
+}
+
+/* Set up the integration from the limits saved by XROM and put the first
+ * abscissa into x.
+ */
+static void de_init(decNumber *x) {
+	struct de_state s;
+	decNumber a, b, eps, t, u;
+	int digits, maxlevel, zero = 0;
+
+	getRegister(&b, DE_B);
+	getRegister(&a, DE_A);
+	if (dn_gt(&a, &b))
+		set_user_flag(DE_REV);
+	if (decNumberIsInfinite(&a) && decNumberIsInfinite(&b)) {
+		s.kind = DE_SINH_SINH;
+		decNumberZero(&s.bpa2);
+		dn_1(&s.bma2);
+		zero = 1;
+	} else if (decNumberIsInfinite(&a) || decNumberIsInfinite(&b)) {
+		// Integrate from the finite limit towards the infinite one
+		const int inf_a = decNumberIsInfinite(&a);
+
+		s.kind = DE_EXP_SINH;
+		set_user_flag(DE_ES);
+		if (decNumberIsNegative(inf_a ? &a : &b))
+			set_user_flag(DE_LEFT);
+		decNumberCopy(&s.bpa2, inf_a ? &b : &a);
+		dn_1(&s.bma2);
+		zero = dn_eq0(&s.bpa2);
+	} else {
+		s.kind = DE_TANH_SINH;
+		set_user_flag(DE_TS);
+		dn_add(&t, &a, &b);
+		dn_div2(&s.bpa2, &t);
+		dn_subtract(&t, &b, &a);
+		dn_abs(&u, &t);
+		dn_div2(&s.bma2, &u);
+	}
+
+	// All digits in double precision, else three more than are displayed
+	if (is_dblmode())
+		digits = 34;
+	else {
+		decNumberRecip(&t, &const_9);
+		decNumberRoundDigits(&t, &t, 16, DEC_ROUND_HALF_EVEN);
+		decNumberRnd(&u, &t);
+		dn_subtract(&a, &u, &t);
+		decNumberExponent(&t, &a);
+		digits = 2 - dn_to_int(&t);
+	}
+	int_to_dn(&t, -digits);
+	decNumberPow10(&eps, &t);
+	dn_sqrt(&t, &eps);
+	dn_mulpow10(&u, &t, 1);
+	setRegister(DE_THR, &u);
+
+	// round(log2(digits)) + 2 levels after level 0
+	for (maxlevel = 0; digits * digits >= 2 << (2 * maxlevel); maxlevel++);
+	int_to_dn(&t, maxlevel + 2);
+	setRegister(DE_LVL, &t);
+
+	// The largest t keeps the abscissae representable and away from the
+	// limits, zero allows a smaller epsilon
+	if (zero)
+		decNumberULP(&eps, &const_0);
+	setRegister(DE_EPS, &eps);
+	if (s.kind == DE_TANH_SINH) {
+		dn_min(&u, &const_1, &s.bma2);
+		dn_mul2(&t, &u);
+	} else if (! zero) {
+		dn_divide(&u, &const_0_5, &s.bpa2);
+		dn_abs(&t, &u);
+	} else
+		dn_sqrt(&t, &eps);
+	dn_divide(&u, &t, &eps);
+	dn_ln(&t, &u);
+	dn_mul2(&u, &t);
+	if (s.kind != DE_TANH_SINH)
+		dn_mul2(&u, &u);
+	dn_divide(&t, &u, &const_PI);
+	dn_ln(&u, &t);
+	setRegister(DE_TM, &u);
+
+	decNumberZero(&s.ssp);
+	decNumberZero(&s.fp);
+	decNumberZero(&s.ss);
+	decNumberZero(&s.ss1);
+	dn_1(&s.h);
+	s.j = 1;
+	s.k = 0;
+	de_point(x, &s);
+	de_save(&s);
+}
+
+void integrate(enum nilop op) {
+	const int digits = Ctx.digits;
+	struct de_state s;
+	decNumber f, x, r;
+	enum de_result res;
+
+	if (op == OP_INTI) {
+		de_init(&x);
+		setX(&x);
+		return;
+	}
+
+	// Points where the integrand isn't finite are ignored
+	getX(&f);
+	if (decNumberIsSpecial(&f))
+		decNumberZero(&f);
+	de_load(&s);
+	Ctx.digits = is_dblmode() ? 34 : 16;
+	res = de_step(&x, &r, &s, &f);
+	Ctx.digits = digits;
+	de_save(&s);
+
+	setX(&x);
+	if (res == DE_CALL) {
+		fin_tst(1);
+		return;
+	}
+	solver_push(&r);
+	if (res == DE_FINISHED)
+		solver_push(&r);
+	fin_tst(0);
+}
+
+/* The loop behind SIGMA and PRODUCT.
+ *
+ * XROM calls the user's function and passes each value to SUMS or PRDS.
+ * The first value starts the sum or product, later ones are added using
+ * Kahan's compensated summation or multiplied in.  Then the counter is
+ * decremented as DSL would and, while the loop continues, the next argument
+ * is left in X and the following instruction executed.  A value that isn't
+ * finite makes the result NaN and ends the loop.  The arithmetic is carried
+ * out at register precision as the keystroke version did.
+ */
+#define SP_COUNT	(LOCAL_REG_BASE + 0)	// loop counter
+#define SP_RESULT	(LOCAL_REG_BASE + 1)	// sum or product
+#define SP_CARRY	(LOCAL_REG_BASE + 2)	// Kahan carry for sums
+#define SP_STARTED	(LOCAL_FLAG_BASE + 0)	// first value has been seen
+
+void sum_product(enum nilop op) {
+	const int digits = Ctx.digits;
+	decNumber f, s, c, y, t, u;
+
+	getX(&f);
+	if (decNumberIsSpecial(&f)) {
+		setRegister(SP_RESULT, set_NaN(&s));
+		fin_tst(0);
+		return;
+	}
+	if (! get_user_flag(SP_STARTED)) {
+		set_user_flag(SP_STARTED);
+		setRegister(SP_RESULT, &f);
+		setRegister(SP_CARRY, decNumberZero(&c));
+	} else {
+		getRegister(&s, SP_RESULT);
+		Ctx.digits = is_dblmode() ? 34 : 16;
+		if (op == OP_SUMS) {
+			getRegister(&c, SP_CARRY);
+			dn_subtract(&y, &f, &c);
+			dn_add(&t, &s, &y);
+			dn_subtract(&u, &t, &s);
+			dn_subtract(&c, &u, &y);
+			setRegister(SP_CARRY, &c);
+		} else
+			dn_multiply(&t, &s, &f);
+		Ctx.digits = digits;
+		setRegister(SP_RESULT, &t);
+	}
+	cmdloop(SP_COUNT, RARG_DSL);
+	getRegister(&s, SP_COUNT);
+	setX(decNumberTrunc(&t, &s));
+}
@@ -29,7 +29,7 @@
 /*
  *  Define register block
  */
-STAT_DATA *StatRegs;
+PER_INSTANCE STAT_DATA *StatRegs;
 
 #define sigmaN		(StatRegs->sN)
 #define sigmaX		(StatRegs->sX)
@@ -49,7 +49,7 @@ STAT_DATA *StatRegs;
 /*
  *  Actual size of this block (may be zero)
  */
-SMALL_INT SizeStatRegs;
+PER_INSTANCE SMALL_INT SizeStatRegs;
 
 /*
  *  Handle block (de)allocation
@@ -148,27 +148,33 @@ static void sigop(decimal64 *r, const decNumber *a, decNumber *(*op)(decNumber *
 	packed_from_number(r, &u);
 }
 
-static void sigop128(decimal128 *r, const decNumber *a, decNumber *(*op)(decNumber *, const decNumber *, const decNumber *)) {
-	decNumber t, u;
-
-	decimal128ToNumber(r, &t);
-	(*op)(&u, &t, a);
-	packed128_from_number(r, &u);
-}
-
 
 /* Multiply a pair of values and accumulate into the sigma data.
+ * The product is added or subtracted exactly and rounded once.
  */
+static void mulop_acc(decAccumulator *acc, const decNumber *a, const decNumber *b, decNumber *(*op)(decNumber *, const decNumber *, const decNumber *)) {
+	if (op == &dn_subtract)
+		dn_acc_msc(acc, a, b);
+	else
+		dn_acc_mac(acc, a, b);
+}
+
 static void mulop(decimal64 *r, const decNumber *a, const decNumber *b, decNumber *(*op)(decNumber *, const decNumber *, const decNumber *)) {
 	decNumber t;
+	decAccumulator acc;
 
-	sigop(r, dn_multiply(&t, a, b), op);
+	dn_acc_init(&acc, decimal64ToNumber(r, &t));
+	mulop_acc(&acc, a, b, op);
+	packed_from_number(r, &acc.n);
 }
 
 static void mulop128(decimal128 *r, const decNumber *a, const decNumber *b, decNumber *(*op)(decNumber *, const decNumber *, const decNumber *)) {
 	decNumber t;
+	decAccumulator acc;
 
-	sigop128(r, dn_multiply(&t, a, b), op);
+	dn_acc_init(&acc, decimal128ToNumber(r, &t));
+	mulop_acc(&acc, a, b, op);
+	packed128_from_number(r, &acc.n);
 }
 
 
@@ -523,7 +529,7 @@ decNumber *stats_sigper(decNumber *res, const decNumber *x) {
 	decNumber sx, t;
 
 	if (sigmaCheck())
-		return res;
+		return NULL;
 	get_sigmas(NULL, &sx, NULL, NULL, NULL, NULL, SIGMA_QUIET_LINEAR);
 	dn_divide(&t, x, &sx);
 	return dn_mul100(res, &t);
@@ -869,3 +875,1162 @@ decNumber *betai(decNumber *r, const decNumber *b, const decNumber *a, const dec
 	}
 }
 
+
+#ifdef INCLUDE_NATIVE_DISTRIBUTIONS
+/**************************************************************************/
+/* The normal, t, chi squared, F, Poisson and binomial distributions.
+ *
+ * These follow the XROM routines step for step, including their limits,
+ * parameter errors and iteration counts, but carry the full working
+ * precision between steps.  A NaN argument gives NaN as xIN does.
+ */
+
+#define DIST_F		0
+#define DIST_POISSON	1
+#define DIST_BINOMIAL	2
+
+#define is_frac(x)	(! decNumberIsSpecial(x) && ! is_int(x))
+
+static decNumber *bad_param(decNumber *r) {
+	err(ERR_BAD_PARAM);
+	return decNumberZero(r);
+}
+
+/* Parameter must be finite */
+static int param_special(const decNumber *a) {
+	return decNumberIsSpecial(a);
+}
+
+/* Parameter must be finite and not negative */
+static int param_notneg(const decNumber *a) {
+	return decNumberIsSpecial(a) || dn_lt0(a);
+}
+
+/* Parameter must be finite and positive */
+static int param_pos(const decNumber *a) {
+	return decNumberIsSpecial(a) || dn_le0(a);
+}
+
+/* A probability parameter: NaN gives NaN, out of range is an error */
+static int param_probability(decNumber *r, const decNumber *p) {
+	if (decNumberIsNaN(p)) {
+		set_NaN(r);
+		return 1;
+	}
+	if (dn_lt0(p) || dn_gt(p, &const_1)) {
+		bad_param(r);
+		return 1;
+	}
+	return 0;
+}
+
+/* The argument of a quantile function: anything outside [0, 1] gives NaN */
+static int qf_check_probability(decNumber *r, const decNumber *p) {
+	if (decNumberIsNaN(p) || dn_lt0(p) || dn_gt(p, &const_1)) {
+		set_NaN(r);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**************************************************************************/
+/* Standard normal distribution
+ */
+decNumber *pdf_Q(decNumber *r, const decNumber *x) {
+	decNumber t, u;
+
+	decNumberSquare(&t, x);
+	dn_div2(&u, &t);
+	dn_minus(&t, &u);
+	dn_exp(&u, &t);
+	return dn_divide(r, &u, &const_sqrt2PI);
+}
+
+/* Either tail from the incomplete gamma function of x^2/2:
+ * lower = (1 + gammap(1/2, x^2/2) / sqrt(PI)) / 2, upper = gammaq(1/2, x^2/2) / sqrt(PI) / 2
+ */
+static decNumber *q_tail(decNumber *r, const decNumber *x, int lower) {
+	decNumber t, u;
+
+	decNumberSquare(&t, x);
+	dn_div2(&u, &t);
+	dn_gammainc(&t, &u, &const_0_5, 0, ! lower);
+	dn_divide(&u, &t, &const_sqrtPI);
+	if (lower)
+		dn_inc(&u);
+	return dn_div2(r, &u);
+}
+
+static decNumber *cdf_q(decNumber *r, const decNumber *x) {
+	return q_tail(r, x, ! decNumberIsNegative(x));
+}
+
+static decNumber *cdfu_q(decNumber *r, const decNumber *x) {
+	return q_tail(r, x, decNumberIsNegative(x));
+}
+
+decNumber *cdf_Q(decNumber *r, const decNumber *x) {
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	return cdf_q(r, x);
+}
+
+decNumber *cdfu_Q(decNumber *r, const decNumber *x) {
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	return cdfu_q(r, x);
+}
+
+/* Signed first estimate of the normal quantile, q is set to min(p, 1-p)
+ */
+static decNumber *qf_q_est(decNumber *r, decNumber *q, const decNumber *p) {
+	decNumber a, t, u;
+	int small;
+
+	dn_1m(&a, p);
+	dn_min(q, p, &a);
+	small = ! dn_eq(q, &a);
+	if (dn_lt(q, &const_0_2)) {
+		dn_ln(&t, q);
+		dn_mul2(&u, &t);
+		dn_minus(&a, &u);		// a = -2 ln q
+		dn_m1(&t, &a);
+		dn_multiply(&u, &t, &const_2PI);
+		dn_sqrt(&t, &u);
+		dn_multiply(&u, &t, q);
+		dn_ln(&t, &u);
+		dn_mul2(&u, &t);
+		dn_minus(&t, &u);
+		dn_sqrt(&u, &t);
+		dn_divide(&t, &const_0_264, &a);
+		dn_add(r, &u, &t);
+	} else {
+		dn_subtract(&t, &const_0_5, q);
+		dn_multiply(&a, &t, &const_sqrt2PI);
+		decNumberCube(&t, &a);
+		dn_divide(&u, &t, &const_5);
+		dn_add(r, &a, &u);
+	}
+	if (small)
+		dn_minus(r, r);
+	return r;
+}
+
+/* Dieter's quantile: the estimate refined by one or two steps of a third
+ * order method.  p must be a valid probability.
+ */
+static decNumber *qf_q(decNumber *r, const decNumber *p) {
+	decNumber q, z, d, t, u, v;
+	int half, loops = 2;
+
+	qf_q_est(&z, &q, p);
+	half = decNumberIsNegative(&z);
+	dn_abs(&z, &z);
+	dn_p1(&t, &z);
+	decNumberRoundDigits(&u, &t, 3, DEC_ROUND_HALF_EVEN);
+	if (dn_eq1(&u)) {
+		loops = 1;
+		dn_mulpow10(&t, &z, 16);
+		if (! dn_gt(&t, &const_1))
+			goto out;
+	}
+	do {
+		if (dn_lt(&z, &const_1)) {
+			decNumberSquare(&t, &z);
+			dn_div2(&u, &t);
+			dn_gammainc(&t, &u, &const_0_5, 1, 0);
+			dn_div2(&u, &t);
+			dn_subtract(&t, &const_0_5, &q);
+			dn_subtract(&d, &t, &u);
+		} else {
+			cdfu_q(&t, &z);
+			dn_subtract(&d, &t, &q);
+		}
+		pdf_Q(&u, &z);
+		dn_divide(&t, &d, &u);			// t = d / pdf
+		decNumberSquare(&u, &z);
+		dn_mul2(&v, &u);
+		dn_inc(&v);
+		decNumberCube(&u, &t);
+		dn_multiply(&d, &u, &v);
+		dn_divide(&v, &d, &const_6);		// v = t^3 (2 z^2 + 1) / 6
+		dn_multiply(&u, &z, &t);
+		dn_multiply(&d, &u, &t);
+		dn_div2(&u, &d);			// u = z t^2 / 2
+		dn_add(&d, &v, &u);
+		dn_add(&u, &d, &t);
+		dn_add(&z, &z, &u);
+	} while (--loops);
+out:	if (half)
+		return dn_minus(r, &z);
+	return decNumberCopy(r, &z);
+}
+
+decNumber *qf_Q(decNumber *r, const decNumber *p) {
+	if (qf_check_probability(r, p))
+		return r;
+	return qf_q(r, p);
+}
+
+
+/**************************************************************************/
+/* Normal distribution
+ * Two parameters:
+ *	J = mean
+ *	K = standard deviation > 0
+ */
+static int normal_param(decNumber *r, decNumber *z, decNumber *sigma, const decNumber *x) {
+	decNumber mu, t;
+
+	getRegister(&mu, regJ_idx);
+	getRegister(sigma, regK_idx);
+	if (param_special(&mu) || param_pos(sigma)) {
+		bad_param(r);
+		return 1;
+	}
+	dn_subtract(&t, x, &mu);
+	dn_divide(z, &t, sigma);
+	return 0;
+}
+
+decNumber *pdf_N(decNumber *r, const decNumber *x) {
+	decNumber z, sigma, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (normal_param(r, &z, &sigma, x))
+		return r;
+	pdf_Q(&t, &z);
+	return dn_divide(r, &t, &sigma);
+}
+
+/* Infinite arguments skip the parameter checks and, as in XROM, give the
+ * same limits for either tail.
+ */
+static decNumber *cdf_infinite(decNumber *r, const decNumber *x) {
+	return decNumberIsNegative(x) ? decNumberZero(r) : dn_1(r);
+}
+
+decNumber *cdf_N(decNumber *r, const decNumber *x) {
+	decNumber z, sigma;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (decNumberIsInfinite(x))
+		return cdf_infinite(r, x);
+	if (normal_param(r, &z, &sigma, x))
+		return r;
+	return cdf_q(r, &z);
+}
+
+decNumber *cdfu_N(decNumber *r, const decNumber *x) {
+	decNumber z, sigma;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (decNumberIsInfinite(x))
+		return cdf_infinite(r, x);
+	if (normal_param(r, &z, &sigma, x))
+		return r;
+	return cdfu_q(r, &z);
+}
+
+decNumber *qf_N(decNumber *r, const decNumber *p) {
+	decNumber mu, sigma, t, u;
+
+	if (qf_check_probability(r, p))
+		return r;
+	qf_q(&t, p);
+	getRegister(&mu, regJ_idx);
+	getRegister(&sigma, regK_idx);
+	if (param_special(&mu) || param_pos(&sigma))
+		return bad_param(r);
+	dn_multiply(&u, &t, &sigma);
+	return dn_add(r, &u, &mu);
+}
+
+
+/**************************************************************************/
+/* Chi squared distribution
+ * One parameter:
+ *	J = degrees of freedom, non-negative integer
+ */
+static int chi2_param(decNumber *r, decNumber *k) {
+	getRegister(k, regJ_idx);
+	if (param_notneg(k) || ! is_int(k)) {
+		bad_param(r);
+		return 1;
+	}
+	return 0;
+}
+
+static decNumber *chi2_pdf(decNumber *r, const decNumber *x, const decNumber *k) {
+	decNumber h, s, t, u;
+
+	if (dn_le0(x))
+		return decNumberZero(r);
+	dn_div2(&h, k);
+	dn_ln(&t, x);
+	dn_m1(&u, &h);
+	dn_multiply(&s, &u, &t);
+	dn_div2(&t, x);
+	dn_subtract(&u, &s, &t);		// (k/2-1) ln x - x/2
+	decNumberLnGamma(&t, &h);
+	dn_subtract(&s, &u, &t);
+	dn_multiply(&t, &h, &const_ln2);
+	dn_subtract(&u, &s, &t);
+	return dn_exp(r, &u);
+}
+
+static decNumber *chi2_cdf(decNumber *r, const decNumber *x, const decNumber *k, int upper) {
+	decNumber h, t;
+
+	if (dn_le0(x))
+		return upper ? dn_1(r) : decNumberZero(r);
+	if (decNumberIsInfinite(x))
+		return upper ? decNumberZero(r) : dn_1(r);
+	dn_div2(&t, x);
+	dn_div2(&h, k);
+	return dn_gammainc(r, &t, &h, 1, upper);
+}
+
+decNumber *pdf_chi2(decNumber *r, const decNumber *x) {
+	decNumber k;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (chi2_param(r, &k))
+		return r;
+	return chi2_pdf(r, x, &k);
+}
+
+decNumber *cdf_chi2(decNumber *r, const decNumber *x) {
+	decNumber k;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (chi2_param(r, &k))
+		return r;
+	return chi2_cdf(r, x, &k, 0);
+}
+
+decNumber *cdfu_chi2(decNumber *r, const decNumber *x) {
+	decNumber k;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (chi2_param(r, &k))
+		return r;
+	return chi2_cdf(r, x, &k, 1);
+}
+
+/* Estimate from the lower tail for small p, else Wilson-Hilferty or its
+ * upper tail correction, then at most six Halley steps.
+ */
+decNumber *qf_chi2(decNumber *r, const decNumber *p) {
+	decNumber k, h, x, c, q, P, L, f, d, e, t, u;
+	int i;
+
+	if (decNumberIsNaN(p))
+		return set_NaN(r);
+	if (chi2_param(r, &k) || qf_check_probability(r, p))
+		return r;
+	if (dn_eq0(p))
+		return decNumberCopy(r, p);
+	dn_div2(&h, &k);
+	if (dn_eq1(&k))
+		decNumberZero(&t);
+	else
+		dn_minus(&t, &k);
+	dn_power(&u, &const_1_9, &t);
+	dn_divide(&c, &u, &const_PI);		// c = 1.9^-k / PI
+	if (dn_lt(p, &c)) {
+		dn_multiply(&t, p, &h);
+		dn_ln(&u, &t);
+		decNumberLnGamma(&t, &h);
+		dn_add(&c, &u, &t);
+		dn_mul2(&t, &c);
+		dn_divide(&u, &t, &k);
+		dn_exp(&t, &u);
+		dn_mul2(&x, &t);
+	} else {
+		qf_q_est(&e, &q, p);
+		dn_divide(&c, &const_0_222, &k);
+		dn_sqrt(&t, &c);
+		dn_multiply(&u, &e, &t);
+		dn_inc(&u);
+		dn_subtract(&t, &u, &c);
+		decNumberCube(&u, &t);
+		dn_multiply(&x, &u, &k);		// Wilson-Hilferty
+		dn_multiply(&t, &const_e, &k);
+		dn_add(&c, &t, &const_8);
+		if (! dn_lt(&x, &c)) {
+			dn_div2(&t, &x);
+			dn_ln(&u, &t);
+			dn_m1(&t, &h);
+			dn_multiply(&c, &t, &u);
+			dn_minus(&u, &c);
+			dn_minus(&t, p);
+			decNumberLn1p(&c, &t);
+			dn_add(&t, &u, &c);
+			decNumberLnGamma(&c, &h);
+			dn_add(&u, &t, &c);
+			dn_mul2(&t, &u);
+			dn_minus(&x, &t);
+		}
+	}
+
+	for (i = 0; i < 6; i++) {
+		if (dn_ge(&x, &k)) {
+			chi2_cdf(&q, &x, &k, 1);
+			dn_1m(&P, &q);
+			dn_1m(&t, p);
+			dn_subtract(&u, &t, &q);
+			dn_divide(&t, &u, p);
+			decNumberLn1p(&L, &t);
+		} else {
+			chi2_cdf(&P, &x, &k, 0);
+			dn_divide(&t, &P, p);
+			dn_ln(&L, &t);
+		}
+		chi2_pdf(&t, &x, &k);
+		dn_divide(&f, &t, &P);			// f = pdf / cdf
+		dn_divide(&d, &L, &f);			// d = ln(cdf / p) cdf / pdf
+		dn_p2(&t, &x);
+		dn_subtract(&u, &k, &t);
+		dn_divide(&t, &u, &x);
+		dn_mul2(&u, &f);
+		dn_subtract(&e, &t, &u);		// e = (k-2-x)/x - 2f
+		dn_divide(&t, &e, &const_4);
+		dn_multiply(&u, &t, &d);
+		dn_1m(&t, &u);
+		dn_divide(&u, &d, &t);
+		dn_subtract(&t, &x, &u);
+		if (relative_error(&t, &x, &const_1e_14))
+			return decNumberCopy(r, &t);
+		decNumberCopy(&x, &t);
+		busy();
+	}
+	err(ERR_SOLVE);
+	return decNumberCopy(r, &x);
+}
+
+
+/**************************************************************************/
+/* Student's t distribution
+ * One parameter:
+ *	J = degrees of freedom, real > 0 or infinite for the normal distribution
+ */
+static int t_param(decNumber *r, decNumber *v, int *normal) {
+	getRegister(v, regJ_idx);
+	*normal = decNumberIsInfinite(v) && ! decNumberIsNegative(v);
+	if (! *normal && param_pos(v)) {
+		bad_param(r);
+		return 1;
+	}
+	return 0;
+}
+
+static decNumber *t_pdf(decNumber *r, const decNumber *x, const decNumber *v) {
+	decNumber h, s, t, u, x2;
+
+	decNumberSquare(&x2, x);
+	dn_div2(&t, v);
+	decNumberLnGamma(&u, &t);
+	dn_add(&h, &t, &const_0_5);		// h = (v+1)/2
+	decNumberLnGamma(&t, &h);
+	dn_subtract(&s, &t, &u);
+	dn_divide(&t, &x2, v);
+	decNumberLn1p(&u, &t);
+	dn_multiply(&t, &u, &h);
+	dn_subtract(&u, &s, &t);
+	dn_exp(&s, &u);
+	dn_mulPI(&t, v);
+	dn_sqrt(&u, &t);
+	return dn_divide(r, &s, &u);
+}
+
+/* Lower tail for x < 0 from the incomplete beta function */
+static decNumber *t_tail(decNumber *r, const decNumber *x, const decNumber *v) {
+	decNumber h, t, u, x2;
+
+	decNumberSquare(&x2, x);
+	dn_add(&t, &x2, v);
+	dn_div2(&h, v);
+	if (dn_lt(&x2, &const_1)) {
+		dn_divide(&u, &x2, &t);
+		betai(&t, &h, &const_0_5, &u);
+		dn_div2(&u, &t);
+		return dn_subtract(r, &const_0_5, &u);
+	}
+	dn_divide(&u, v, &t);
+	betai(&t, &const_0_5, &h, &u);
+	return dn_div2(r, &t);
+}
+
+static decNumber *t_cdf(decNumber *r, const decNumber *x, const decNumber *v) {
+	decNumber t;
+
+	if (decNumberIsInfinite(x))
+		return cdf_infinite(r, x);
+	if (dn_eq0(x))
+		return decNumberCopy(r, &const_0_5);
+	if (dn_gt0(x)) {
+		dn_minus(&t, x);
+		t_tail(&t, &t, v);
+		return dn_1m(r, &t);
+	}
+	return t_tail(r, x, v);
+}
+
+decNumber *pdf_T(decNumber *r, const decNumber *x) {
+	decNumber v;
+	int normal;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (t_param(r, &v, &normal))
+		return r;
+	if (normal)
+		return pdf_Q(r, x);
+	return t_pdf(r, x, &v);
+}
+
+decNumber *cdf_T(decNumber *r, const decNumber *x) {
+	decNumber v;
+	int normal;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (t_param(r, &v, &normal))
+		return r;
+	if (normal)
+		return cdf_q(r, x);
+	return t_cdf(r, x, &v);
+}
+
+decNumber *cdfu_T(decNumber *r, const decNumber *x) {
+	decNumber mx;
+
+	dn_minus(&mx, x);
+	return cdf_T(r, &mx);
+}
+
+/* Tail or central estimate followed by at most seven Halley steps */
+decNumber *qf_T(decNumber *r, const decNumber *p) {
+	decNumber v, q, t, d, f, u, w, c, h;
+	int normal, neg, i;
+
+	if (decNumberIsNaN(p))
+		return set_NaN(r);
+	if (t_param(r, &v, &normal) || qf_check_probability(r, p))
+		return r;
+	if (normal)			// XROM returns the probability here
+		return decNumberCopy(r, p);
+	if (dn_eq0(p))
+		return set_neginf(r);
+
+	dn_1m(&u, p);
+	dn_min(&q, p, &u);
+	neg = ! dn_eq(&q, &u);
+	dn_sqrt(&t, &v);
+	dn_add(&u, &t, &const_7);
+	dn_minus(&t, &v);
+	dn_power(&w, &u, &t);
+	dn_divide(&c, &w, &const_4);		// c = (sqrt(v) + 7)^-v / 4
+	if (dn_gt(&q, &c)) {
+		qf_q_est(&u, &h, &q);
+		decNumberSquare(&w, &u);
+		dn_multiply(&u, &const_e, &v);
+		decNumberRecip(&t, &u);
+		dn_inc(&t);
+		dn_multiply(&u, &w, &t);
+		dn_divide(&w, &u, &v);
+		decNumberExpm1(&u, &w);
+		dn_multiply(&w, &u, &v);
+		dn_sqrt(&t, &w);
+	} else {
+		dn_mul2(&w, &v);
+		dn_multiply(&h, &w, &q);
+		dn_subtract(&u, &w, &const_0_75);
+		dn_divide(&c, &const_PI, &u);
+		dn_sqrt(&u, &c);
+		dn_multiply(&c, &h, &u);
+		decNumberRecip(&u, &v);
+		dn_power(&w, &c, &u);
+		dn_sqrt(&u, &v);
+		dn_divide(&t, &u, &w);
+	}
+
+	for (i = 0; i < 7; i++) {
+		decNumberSquare(&w, &t);
+		if (dn_lt(&w, &const_1)) {
+			dn_add(&u, &w, &v);
+			dn_divide(&c, &w, &u);
+			dn_div2(&h, &v);
+			betai(&u, &h, &const_0_5, &c);
+			dn_div2(&c, &u);
+			dn_subtract(&u, &const_0_5, &q);
+			dn_subtract(&d, &u, &c);
+		} else {
+			dn_minus(&u, &t);
+			t_cdf(&c, &u, &v);
+			dn_subtract(&d, &c, &q);
+		}
+		t_pdf(&f, &t, &v);
+		dn_divide(&d, &d, &f);
+		dn_multiply(&u, &d, &t);
+		dn_p1(&c, &v);
+		dn_multiply(&h, &u, &c);
+		dn_add(&u, &w, &v);
+		dn_mul2(&c, &u);
+		dn_divide(&u, &h, &c);
+		dn_dec(&u);
+		dn_divide(&c, &d, &u);
+		dn_subtract(&u, &t, &c);
+		if (relative_error(&u, &t, &const_1e_14)) {
+			decNumberCopy(&t, &u);
+			goto out;
+		}
+		decNumberCopy(&t, &u);
+		busy();
+	}
+	err(ERR_SOLVE);
+out:	if (neg)
+		return dn_minus(r, &t);
+	return decNumberCopy(r, &t);
+}
+
+
+/**************************************************************************/
+/* F distribution
+ * Two parameters:
+ *	J = df1 (real > 0)
+ *	K = df2 (real > 0)
+ */
+static int f_param(decNumber *r, decNumber *d1, decNumber *d2) {
+	getRegister(d1, regJ_idx);
+	getRegister(d2, regK_idx);
+	if (param_pos(d1) || param_pos(d2)) {
+		bad_param(r);
+		return 1;
+	}
+	return 0;
+}
+
+static decNumber *f_pdf(decNumber *r, const decNumber *x, const decNumber *d1, const decNumber *d2) {
+	decNumber s, t, u, xd1;
+
+	dn_ln(&t, d2);
+	dn_multiply(&s, &t, d2);
+	dn_multiply(&xd1, d1, x);
+	dn_ln(&t, &xd1);
+	dn_multiply(&u, &t, d1);
+	dn_add(&t, &s, &u);
+	dn_add(&u, &xd1, d2);
+	dn_ln(&s, &u);
+	dn_add(&u, d1, d2);
+	dn_multiply(&xd1, &s, &u);
+	dn_subtract(&u, &t, &xd1);
+	dn_div2(&s, &u);
+	dn_div2(&t, d1);
+	dn_div2(&u, d2);
+	decNumberLnBeta(&xd1, &t, &u);
+	dn_subtract(&t, &s, &xd1);
+	dn_exp(&u, &t);
+	return dn_divide(r, &u, x);
+}
+
+static decNumber *f_cdf(decNumber *r, const decNumber *x, const decNumber *d1, const decNumber *d2, int upper) {
+	decNumber a, b, t, u, w;
+
+	if (dn_le0(x))
+		return upper ? dn_1(r) : decNumberZero(r);
+	if (decNumberIsInfinite(x))
+		return upper ? decNumberZero(r) : dn_1(r);
+	dn_multiply(&t, x, d1);
+	dn_add(&u, &t, d2);
+	dn_div2(&a, d1);
+	dn_div2(&b, d2);
+	if (upper) {
+		dn_divide(&w, d2, &u);
+		return betai(r, &a, &b, &w);
+	}
+	dn_divide(&w, &t, &u);
+	return betai(r, &b, &a, &w);
+}
+
+decNumber *pdf_F(decNumber *r, const decNumber *x) {
+	decNumber d1, d2;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (f_param(r, &d1, &d2))
+		return r;
+	return f_pdf(r, x, &d1, &d2);
+}
+
+decNumber *cdf_F(decNumber *r, const decNumber *x) {
+	decNumber d1, d2;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (f_param(r, &d1, &d2))
+		return r;
+	return f_cdf(r, x, &d1, &d2, 0);
+}
+
+decNumber *cdfu_F(decNumber *r, const decNumber *x) {
+	decNumber d1, d2;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (f_param(r, &d1, &d2))
+		return r;
+	return f_cdf(r, x, &d1, &d2, 1);
+}
+
+
+/**************************************************************************/
+/* Newton's method for the quantiles of the F, Poisson and binomial
+ * distributions.  The steps are limited to three quarters of the estimate,
+ * the solution is never negative and is bracketed as soon as the cdf has
+ * been seen on both sides of the target.  The discrete distributions take
+ * a secant slope and finish on the integer whose cdf first reaches p.
+ */
+static decNumber *qf_newton_cdf(decNumber *r, int dist, const decNumber *x, const decNumber *a1, const decNumber *a2);
+
+static decNumber *qf_newton(decNumber *r, int dist, const decNumber *p, const decNumber *est, const decNumber *a1, const decNumber *a2) {
+	decNumber low, high, maxstep, rr, w, z, s, t;
+	const decNumber * const cnvg_threshold = convergence_threshold();
+	const int discrete = dist != DIST_F;
+	int nobisect = 0, i;
+
+	dn_multiply(&maxstep, est, &const_0_75);
+	set_inf(&high);
+	decNumberZero(&low);
+	decNumberCopy(&rr, est);
+	if (decNumberIsNaN(&rr))		// XROM's comparisons all fail and it never recovers
+		return set_NaN(r);
+
+	for (i = 0; i < 100; i++) {
+		if (dn_ge(&rr, &high) || dn_le(&rr, &low)) {
+			if (decNumberIsInfinite(&high))
+				dn_add(&rr, &low, &low);
+			else if (decNumberIsInfinite(&low))
+				dn_div2(&rr, &high);
+			else {
+bisect:				dn_average(&rr, &low, &high);
+				nobisect = 1;
+			}
+		}
+		qf_newton_cdf(&w, dist, &rr, a1, a2);
+		dn_subtract(&z, &w, p);
+		if (! dn_lt0(&z)) {
+			if (! nobisect && ! dn_lt(&rr, &high) && ! decNumberIsInfinite(&low))
+				goto bisect;
+			dn_min(&high, &high, &rr);
+		} else {
+			if (! nobisect && ! dn_gt(&rr, &low) && ! decNumberIsInfinite(&high))
+				goto bisect;
+			dn_max(&low, &low, &rr);
+		}
+		nobisect = 0;
+
+		if (discrete) {
+			dn_add(&t, &rr, &const_0_001);
+			qf_newton_cdf(&s, dist, &t, a1, a2);
+			dn_subtract(&t, &s, &w);
+			dn_mulpow10(&s, &t, 3);
+		} else
+			f_pdf(&s, &rr, a1, a2);
+		if (dn_eq0(&s))
+			goto done;
+		dn_divide(&w, &z, &s);
+
+		// Limit the step size
+		dn_abs(&t, &w);
+		if (! dn_lt(&t, &maxstep)) {
+			if (decNumberIsNegative(&w))
+				dn_minus(&w, &maxstep);
+			else
+				decNumberCopy(&w, &maxstep);
+		}
+
+		// Update the estimate staying positive
+		decNumberCopy(&z, &rr);
+		dn_subtract(&rr, &z, &w);
+		if (dn_lt0(&rr))
+			dn_mulpow10(&rr, &z, -5);
+
+		// Give up when the bounds are close enough together
+		if (! decNumberIsInfinite(&high) && ! decNumberIsInfinite(&low) &&
+				relative_error(&low, &high, cnvg_threshold)) {
+			dn_average(&rr, &low, &high);
+			goto done;
+		}
+
+		if (discrete) {
+			if (absolute_error(&z, &rr, DISCRETE_TOLERANCE))
+				goto done;
+		} else if (relative_error(&rr, &z, cnvg_threshold))
+			goto done;
+		busy();
+	}
+	return set_NaN(r);
+
+done:	if (discrete) {
+		decNumberFloor(&rr, &rr);
+		qf_newton_cdf(&s, dist, &rr, a1, a2);
+		// Compare at register precision as XROM does, else a probability
+		// which is hit exactly, such as a median, can be missed in the last digit
+		decNumberRoundDigits(&t, &s, 34, DEC_ROUND_HALF_EVEN);
+		if (dn_lt(&t, p))
+			dn_inc(&rr);
+	}
+	return decNumberCopy(r, &rr);
+}
+
+/* The normal approximation with a skew correction used to start the
+ * discrete searches
+ */
+static decNumber *normal_moment_approx(decNumber *r, const decNumber *p, const decNumber *sd, const decNumber *mean) {
+	decNumber q, z, t, u;
+
+	qf_q_est(&z, &q, p);
+	decNumberSquare(&t, &z);
+	dn_m1(&u, &t);
+	dn_divide(&t, &u, &const_6);
+	dn_divide(&u, &t, sd);
+	dn_add(&t, &u, &z);
+	dn_multiply(&u, &t, sd);
+	return dn_add(r, &u, mean);
+}
+
+/* Wilson-Hilferty style estimate of the F quantile */
+static decNumber *qf_f_est(decNumber *r, const decNumber *p, const decNumber *d1, const decNumber *d2) {
+	decNumber q, z, r1, r2, h, k, a, t, u;
+
+	qf_q_est(&z, &q, p);
+	decNumberCopy(&t, d1);
+	if (dn_gt(&t, &const_1))
+		dn_dec(&t);
+	decNumberRecip(&r1, &t);
+	decNumberCopy(&t, d2);
+	if (dn_gt(&t, &const_1))
+		dn_dec(&t);
+	decNumberRecip(&r2, &t);
+	dn_add(&t, &r1, &r2);
+	dn_divide(&h, &const_2, &t);
+	decNumberSquare(&t, &z);
+	dn_subtract(&u, &t, &const_3);
+	dn_divide(&k, &u, &const_6);
+	dn_add(&t, &h, &k);
+	dn_sqrt(&u, &t);
+	dn_multiply(&t, &u, &z);
+	dn_divide(&a, &t, &h);			// a = z sqrt(h + k) / h
+	dn_multiply(&t, &h, &const_3);
+	dn_divide(&u, &const_2, &t);
+	dn_subtract(&t, &k, &u);
+	dn_add(&u, &t, &const_5on6);		// u = k + 5/6 - 2/(3h)
+	dn_subtract(&t, &r1, &r2);
+	dn_multiply(&q, &t, &u);
+	dn_subtract(&t, &a, &q);
+	dn_mul2(&u, &t);
+	return dn_exp(r, &u);
+}
+
+decNumber *qf_F(decNumber *r, const decNumber *p) {
+	decNumber d1, d2, est;
+
+	if (decNumberIsNaN(p))
+		return set_NaN(r);
+	if (f_param(r, &d1, &d2))
+		return r;
+	qf_f_est(&est, p, &d1, &d2);
+	return qf_newton(r, DIST_F, p, &est, &d1, &d2);
+}
+
+
+/**************************************************************************/
+/* Poisson distribution
+ * One parameter:
+ *	J = lambda
+ * or two parameters giving lambda = J K:
+ *	J = probability
+ *	K = n
+ * A rate which isn't positive gives zero everywhere.
+ */
+static int poisson_param(decNumber *r, decNumber *lambda) {
+	getRegister(lambda, regJ_idx);
+	if (decNumberIsNaN(lambda)) {
+		set_NaN(r);
+		return 1;
+	}
+	if (decNumberIsSpecial(lambda)) {
+		bad_param(r);
+		return 1;
+	}
+	if (dn_le0(lambda)) {
+		decNumberZero(r);
+		return 1;
+	}
+	return 0;
+}
+
+static int poisson2_param(decNumber *r, decNumber *lambda) {
+	decNumber p, n;
+
+	getRegister(&p, regJ_idx);
+	if (param_probability(r, &p))
+		return 1;
+	getRegister(&n, regK_idx);
+	dn_multiply(lambda, &p, &n);
+	if (dn_lt0(lambda)) {
+		decNumberZero(r);
+		return 1;
+	}
+	return 0;
+}
+
+static decNumber *poisson_pdf(decNumber *r, const decNumber *x, const decNumber *lambda) {
+	decNumber s, t, u;
+
+	if (is_frac(x))
+		return decNumberZero(r);
+	dn_ln(&t, lambda);
+	dn_multiply(&u, &t, x);
+	dn_subtract(&s, &u, lambda);
+	dn_p1(&t, x);
+	decNumberLnGamma(&u, &t);
+	dn_subtract(&t, &s, &u);
+	return dn_exp(r, &t);
+}
+
+static decNumber *poisson_cdf(decNumber *r, const decNumber *x, const decNumber *lambda) {
+	decNumber t;
+
+	if (dn_lt0(x))
+		return decNumberZero(r);
+	if (decNumberIsInfinite(x))
+		return dn_1(r);
+	dn_p1(&t, x);
+	return dn_gammainc(r, lambda, &t, 1, 1);
+}
+
+static decNumber *poisson_cdfu(decNumber *r, const decNumber *x, const decNumber *lambda) {
+	decNumber t;
+
+	decNumberCeil(&t, x);
+	if (dn_lt(&t, &const_1))
+		return dn_1(r);
+	if (decNumberIsInfinite(&t))
+		return decNumberZero(r);
+	return dn_gammainc(r, lambda, &t, 1, 0);
+}
+
+static decNumber *poisson_qf(decNumber *r, const decNumber *p, const decNumber *lambda) {
+	decNumber sd, est;
+
+	if (qf_check_probability(r, p))
+		return r;
+	dn_sqrt(&sd, lambda);
+	normal_moment_approx(&est, p, &sd, lambda);
+	return qf_newton(r, DIST_POISSON, p, &est, lambda, NULL);
+}
+
+decNumber *pdf_Plam(decNumber *r, const decNumber *x) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson_param(r, &lambda))
+		return r;
+	return poisson_pdf(r, x, &lambda);
+}
+
+decNumber *cdf_Plam(decNumber *r, const decNumber *x) {
+	decNumber lambda, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson_param(r, &lambda))
+		return r;
+	return poisson_cdf(r, decNumberFloor(&t, x), &lambda);
+}
+
+decNumber *cdfu_Plam(decNumber *r, const decNumber *x) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson_param(r, &lambda))
+		return r;
+	return poisson_cdfu(r, x, &lambda);
+}
+
+decNumber *qf_Plam(decNumber *r, const decNumber *p) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(p))
+		return set_NaN(r);
+	if (poisson_param(r, &lambda))
+		return r;
+	return poisson_qf(r, p, &lambda);
+}
+
+decNumber *pdf_P(decNumber *r, const decNumber *x) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson2_param(r, &lambda))
+		return r;
+	return poisson_pdf(r, x, &lambda);
+}
+
+decNumber *cdf_P(decNumber *r, const decNumber *x) {
+	decNumber lambda, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson2_param(r, &lambda))
+		return r;
+	return poisson_cdf(r, decNumberFloor(&t, x), &lambda);
+}
+
+decNumber *cdfu_P(decNumber *r, const decNumber *x) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (poisson2_param(r, &lambda))
+		return r;
+	return poisson_cdfu(r, x, &lambda);
+}
+
+decNumber *qf_P(decNumber *r, const decNumber *p) {
+	decNumber lambda;
+
+	if (decNumberIsNaN(p))
+		return set_NaN(r);
+	if (poisson2_param(r, &lambda))
+		return r;
+	return poisson_qf(r, p, &lambda);
+}
+
+
+/**************************************************************************/
+/* Binomial distribution
+ * Two parameters:
+ *	J = probability
+ *	K = n, a fractional or negative n gives zero everywhere
+ */
+static int binomial_param(decNumber *r, decNumber *p, decNumber *n) {
+	getRegister(p, regJ_idx);
+	if (param_probability(r, p))
+		return 1;
+	getRegister(n, regK_idx);
+	if (param_special(n)) {
+		bad_param(r);
+		return 1;
+	}
+	if (! is_int(n) || dn_lt0(n)) {
+		decNumberZero(r);
+		return 1;
+	}
+	return 0;
+}
+
+static decNumber *binomial_cdf(decNumber *r, const decNumber *x, const decNumber *p, const decNumber *n) {
+	decNumber a, b, q;
+
+	if (dn_lt0(x))
+		return decNumberZero(r);
+	if (dn_ge(x, n))
+		return dn_1(r);
+	dn_subtract(&a, n, x);
+	dn_p1(&b, x);
+	dn_1m(&q, p);
+	return betai(r, &b, &a, &q);
+}
+
+decNumber *pdf_B(decNumber *r, const decNumber *x) {
+	decNumber p, n, s, t, u;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (binomial_param(r, &p, &n))
+		return r;
+	if (dn_lt0(x) || dn_gt(x, &n))
+		return decNumberZero(r);
+	dn_minus(&t, &p);
+	decNumberLn1p(&u, &t);
+	dn_subtract(&t, &n, x);
+	dn_multiply(&s, &t, &u);
+	dn_exp(&t, &s);
+	decNumberComb(&u, &n, x);
+	dn_multiply(&s, &t, &u);
+	dn_power(&t, &p, x);
+	return dn_multiply(r, &s, &t);
+}
+
+decNumber *cdf_B(decNumber *r, const decNumber *x) {
+	decNumber p, n, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (binomial_param(r, &p, &n))
+		return r;
+	return binomial_cdf(r, decNumberFloor(&t, x), &p, &n);
+}
+
+decNumber *cdfu_B(decNumber *r, const decNumber *x) {
+	decNumber p, n, a, b, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (binomial_param(r, &p, &n))
+		return r;
+	decNumberCeil(&t, x);
+	if (dn_le0(&t))
+		return dn_1(r);
+	dn_m1(&b, &t);
+	if (dn_gt(&b, &n))
+		return decNumberZero(r);
+	dn_subtract(&t, &n, &b);
+	dn_p1(&a, &b);
+	return betai(r, &t, &a, &p);
+}
+
+decNumber *qf_B(decNumber *r, const decNumber *x) {
+	decNumber p, n, mean, sd, est, t;
+
+	if (decNumberIsNaN(x))
+		return set_NaN(r);
+	if (binomial_param(r, &p, &n) || qf_check_probability(r, x))
+		return r;
+	if (dn_le0(x))
+		return decNumberZero(r);
+	dn_multiply(&mean, &p, &n);
+	dn_1m(&t, &p);
+	dn_multiply(&est, &t, &mean);
+	dn_sqrt(&sd, &est);
+	normal_moment_approx(&est, x, &sd, &mean);
+	if (decNumberIsNaN(qf_newton(&t, DIST_BINOMIAL, x, &est, &p, &n)))
+		return set_NaN(r);
+	return dn_min(r, &t, &n);
+}
+
+static decNumber *qf_newton_cdf(decNumber *r, int dist, const decNumber *x, const decNumber *a1, const decNumber *a2) {
+	switch (dist) {
+	case DIST_F:
+		return f_cdf(r, x, a1, a2, 0);
+	case DIST_POISSON:
+		return poisson_cdf(r, x, a1);
+	default:
+		return binomial_cdf(r, x, a1, a2);
+	}
+}
+#endif
@@ -40,7 +40,7 @@ typedef struct _stat_data {
 	signed int sN;		
 } STAT_DATA;
 
-extern STAT_DATA *StatRegs;
+extern PER_INSTANCE STAT_DATA *StatRegs;
 
 extern int  sigmaCheck(void);
 extern void sigmaDeallocate(void);
@@ -73,7 +73,39 @@ extern void stats_random(enum nilop);
 extern void stats_sto_random(enum nilop);
 
 extern decNumber *betai(decNumber *, const decNumber *, const decNumber *, const decNumber *);
-extern decNumber *pdf_Q(decNumber *q, const decNumber *x);
-extern void cdf_Q_helper(enum nilop op);
+#ifdef INCLUDE_NATIVE_DISTRIBUTIONS
+extern decNumber *pdf_Q(decNumber *, const decNumber *);
+extern decNumber *cdf_Q(decNumber *, const decNumber *);
+extern decNumber *cdfu_Q(decNumber *, const decNumber *);
+extern decNumber *qf_Q(decNumber *, const decNumber *);
+extern decNumber *pdf_N(decNumber *, const decNumber *);
+extern decNumber *cdf_N(decNumber *, const decNumber *);
+extern decNumber *cdfu_N(decNumber *, const decNumber *);
+extern decNumber *qf_N(decNumber *, const decNumber *);
+extern decNumber *pdf_chi2(decNumber *, const decNumber *);
+extern decNumber *cdf_chi2(decNumber *, const decNumber *);
+extern decNumber *cdfu_chi2(decNumber *, const decNumber *);
+extern decNumber *qf_chi2(decNumber *, const decNumber *);
+extern decNumber *pdf_T(decNumber *, const decNumber *);
+extern decNumber *cdf_T(decNumber *, const decNumber *);
+extern decNumber *cdfu_T(decNumber *, const decNumber *);
+extern decNumber *qf_T(decNumber *, const decNumber *);
+extern decNumber *pdf_F(decNumber *, const decNumber *);
+extern decNumber *cdf_F(decNumber *, const decNumber *);
+extern decNumber *cdfu_F(decNumber *, const decNumber *);
+extern decNumber *qf_F(decNumber *, const decNumber *);
+extern decNumber *pdf_Plam(decNumber *, const decNumber *);
+extern decNumber *cdf_Plam(decNumber *, const decNumber *);
+extern decNumber *cdfu_Plam(decNumber *, const decNumber *);
+extern decNumber *qf_Plam(decNumber *, const decNumber *);
+extern decNumber *pdf_P(decNumber *, const decNumber *);
+extern decNumber *cdf_P(decNumber *, const decNumber *);
+extern decNumber *cdfu_P(decNumber *, const decNumber *);
+extern decNumber *qf_P(decNumber *, const decNumber *);
+extern decNumber *pdf_B(decNumber *, const decNumber *);
+extern decNumber *cdf_B(decNumber *, const decNumber *);
+extern decNumber *cdfu_B(decNumber *, const decNumber *);
+extern decNumber *qf_B(decNumber *, const decNumber *);
+#endif
 
 #endif
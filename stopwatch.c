@@ -47,50 +47,50 @@
 #define StopWatchKeyticks         (StateWhileOn._keyticks)
 #define STOPWATCH_APD_TICKS 65535 // Largest unsigned short possible in 32 bits. 1 hour 49 min
 
-TStopWatchStatus StopWatchStatus; // ={ 0, 1, 0, 0, };
+PER_INSTANCE TStopWatchStatus StopWatchStatus; // ={ 0, 1, 0, 0, };
 
 /*
  *  KeyCallback is used to call the StopWatch from the main loop
  * And set to NULL when the StopWatch is not running
  */
-int (*KeyCallback)(int)=(int (*)(int)) NULL;
+PER_INSTANCE int (*KeyCallback)(int)=(int (*)(int)) NULL;
 
 /*
  *  Stopwatch uses the ticker count. This is the starting point
  */
-unsigned long FirstTicker;
+PER_INSTANCE unsigned long FirstTicker;
 
 /*
  * When resetting after a Sigma+ or a RoundTime storage, we original FirstTicker
  * here so we can compute TotalStopWatch the exact same way as StopWatch
  */
-unsigned long TotalFirstTicker;
+PER_INSTANCE unsigned long TotalFirstTicker;
 
 /*
  * Current total stopwatch value, in ticker count. Usually set to getTicker() - TotalFirstTicker
  */
-unsigned long TotalStopWatch;
+PER_INSTANCE unsigned long TotalStopWatch;
 
 /*
  * Current stopwatch value, in ticker count. Usually set to getTicker() - FirstTicker
  */
-unsigned long StopWatch;
+PER_INSTANCE unsigned long StopWatch;
 
 /*
  * Index on memory to store split time
  */
-unsigned char StopWatchMemory;
+PER_INSTANCE unsigned char StopWatchMemory;
 
 /*
  * Used to choose a memory index to store split time in
  */
-signed char StopWatchMemoryFirstDigit;
-signed char RclMemory;
+PER_INSTANCE signed char StopWatchMemoryFirstDigit;
+PER_INSTANCE signed char RclMemory;
 
 /*
  * Use to display the chosen memory for a while
  */
-unsigned char RclMemoryRemanentDisplay;
+PER_INSTANCE unsigned char RclMemoryRemanentDisplay;
 
 #define STOPWATCH_RS K63
 #define STOPWATCH_EXIT K60
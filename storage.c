@@ -64,37 +64,37 @@
 /*
  *  Setup the persistent RAM
  */
-PERSISTENT_RAM TPersistentRam PersistentRam;
+PERSISTENT_RAM PER_INSTANCE TPersistentRam PersistentRam;
 
 /*
  *  Data that is saved in the SLCD controller during deep sleep
  */
-SLCDCMEM TStateWhileOn StateWhileOn;
+SLCDCMEM PER_INSTANCE TStateWhileOn StateWhileOn;
 
 /*
  *  A private register area for XROM code in volatile RAM
  *  It replaces the local registers and flags if active.
  */
-TXromParams XromParams;
-VOLATILE_RAM TXromLocal XromLocal;
+PER_INSTANCE TXromParams XromParams;
+VOLATILE_RAM PER_INSTANCE TXromLocal XromLocal;
 
 /* Private space for four registers temporarily
  */
-VOLATILE_RAM REGISTER XromA2D[4];
+VOLATILE_RAM PER_INSTANCE REGISTER XromA2D[4];
 
 /*
  *  The backup flash area:
  *  2 KB for storage of programs and registers
  *  Same data as in persistent RAM but in flash memory
  */
-BACKUP_FLASH TPersistentRam BackupFlash;
+BACKUP_FLASH PER_INSTANCE TPersistentRam BackupFlash;
 
 #ifndef REALBUILD
 /*
  *  We need to define the Library space here.
  *  On the device the linker takes care of this.
  */
-FLASH_REGION UserFlash;
+PER_INSTANCE FLASH_REGION UserFlash;
 #endif
 
 /*
@@ -182,6 +182,7 @@ static void stoend( void )
 {
 	ProgSize = 1;
 	Prog[ 0 ] = ( OP_NIL | OP_END );
+	invalidate_program_index( REGION_RAM );
 }
 
 
@@ -229,6 +230,7 @@ void clrprog( void )
 		clrretstk();
 		xcopy( Prog_1 + ProgBegin, Prog + ProgEnd, ( ProgSize - ProgEnd ) << 1 );
 		ProgSize -= ( ProgEnd + 1 - ProgBegin );
+		invalidate_program_index( REGION_RAM );
 		if ( ProgSize == 0 ) {
 			stoend();
 		}
@@ -304,6 +306,7 @@ void stoprog( opcode c ) {
 		Prog_1[pc + 1] = c >> 16;
 	Prog_1[pc] = c;
 	State.pc = pc;
+	update_program_index( pc, off );
 }
 
 
@@ -326,6 +329,7 @@ void delprog( void )
 	ProgEnd -= off;
 	for ( i = pc; i <= (int) ProgSize; ++i )
 		Prog_1[ i ] = Prog_1[ i + off ];
+	update_program_index( pc, -off );
 	decpc();
 }
 
@@ -379,6 +383,7 @@ int append_program( const s_opcode *source, int length )
 	pc = ProgSize + 1;
 	ProgSize += length;
 	xcopy( Prog_1 + pc, source, length << 1 );
+	invalidate_program_index( REGION_RAM );
 	set_pc( pc );
 	return 0;
 }
@@ -463,6 +468,14 @@ void sam_ba_boot(void)
  *  Page numbers are relative to the start of the user flash
  *  count is in pages, destination % PAGE_SIZE needs to be 0.
  */
+#ifdef INCLUDE_MULTI_INSTANCE
+/*
+ *  Set for an instance which shares the process with others.  Its flash
+ *  writes only go to its own copy in memory, the region files are shared.
+ */
+PER_INSTANCE int PrivateFlash;
+#endif
+
 #if defined(QTGUI) || defined(IOS)
 extern char* get_region_path(int region);
 #else
@@ -490,16 +503,23 @@ static int program_flash( void *destination, void *source, int count )
 	if ( dest >= (char *) &BackupFlash && dest < (char *) &BackupFlash + sizeof( BackupFlash ) ) {
 		name = get_region_path( REGION_BACKUP );
 		offset = dest - (char *) &BackupFlash;
+		invalidate_program_index( REGION_BACKUP );
 	}
 	else if ( dest >= (char *) &UserFlash && dest < (char *) &UserFlash + sizeof( UserFlash ) ) {
 		name = get_region_path( REGION_LIBRARY );
 		offset = dest - (char *) &UserFlash;
+		invalidate_program_index( REGION_LIBRARY );
 	}
 	else {
 		// Bad address
 		err( ERR_ILLEGAL );
 		return 1;
 	}
+#ifdef INCLUDE_MULTI_INSTANCE
+	if ( PrivateFlash ) {
+		return 0;
+	}
+#endif
 	f = fopen( name, "rb+" );
 	if ( f == NULL ) {
 		f = fopen( name, "wb+" );
@@ -815,10 +835,10 @@ void recall_program( enum nilop op )
 #define ASSEMBLER "../tools/wp34s_asm.pl"
 #endif
 #define ASSEMBLER_OPTIONS ""
-char CurrentDir[ FILENAME_MAX + 1 ];
-char StateFile[ FILENAME_MAX + 1 ] = STATE_FILE;
-char ComPort[ FILENAME_MAX + 1 ] = "COM1";
-char Assembler[ FILENAME_MAX + 1 ] = ASSEMBLER;
+PER_INSTANCE char CurrentDir[ FILENAME_MAX + 1 ];
+PER_INSTANCE char StateFile[ FILENAME_MAX + 1 ] = STATE_FILE;
+PER_INSTANCE char ComPort[ FILENAME_MAX + 1 ] = "COM1";
+PER_INSTANCE char Assembler[ FILENAME_MAX + 1 ] = ASSEMBLER;
 
 /*
  *  Show (GUI) message
@@ -953,6 +973,7 @@ void load_statefile(const char *filename )
 		fread( &UserFlash, sizeof( UserFlash ), 1, f );
 		fclose( f );
 	}
+	invalidate_program_index( -1 );
 	init_library();
 
 #if !defined(QTGUI) && !defined(IOS)
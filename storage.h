@@ -35,13 +35,16 @@ typedef struct _flash_region {
         s_opcode prog[ NUMPROG_FLASH ];
 } FLASH_REGION;
 
-extern FLASH_REGION UserFlash;
-extern TPersistentRam BackupFlash;
+extern PER_INSTANCE FLASH_REGION UserFlash;
+extern PER_INSTANCE TPersistentRam BackupFlash;
 
 #ifndef REALBUILD
 // Flag for "Export Program..."
 extern int UseAliasNames;
 #endif
+#ifdef INCLUDE_MULTI_INSTANCE
+extern PER_INSTANCE int PrivateFlash;
+#endif
 
 extern unsigned short int crc16(const void *base, unsigned int length);
 extern unsigned short int checksum_program(void);
@@ -72,9 +75,9 @@ extern void store_program(enum nilop op);
 extern void recall_program(enum nilop op);
 
 #if !defined(REALBUILD) && !defined(IOS)
-extern char StateFile[];
-extern char ComPort[];
-extern char Assembler[];
+extern PER_INSTANCE char StateFile[];
+extern PER_INSTANCE char ComPort[];
+extern PER_INSTANCE char Assembler[];
 extern void save_statefile( const char *filename );
 extern void load_statefile( const char *filename );
 extern void import_textfile( const char *filename );
@@ -66,8 +66,8 @@ extern unsigned long long strtoull(const char *, char **, int);
 /*
  *  A program is running
  */
-FLAG Running;
-FLAG XromRunning;
+PER_INSTANCE FLAG Running;
+PER_INSTANCE FLAG XromRunning;
 
 #ifndef CONSOLE
 /*
@@ -79,81 +79,81 @@ FLAG JustStopped;
 /*
  *  Count down counter for a programmed pause
  */
-volatile unsigned char Pause;
+PER_INSTANCE volatile unsigned char Pause;
 
 /*
  *  Some long running function has called busy();
  */
-FLAG Busy;
+PER_INSTANCE FLAG Busy;
 
 /*
  *  Error code
  */
-SMALL_INT Error;
+PER_INSTANCE SMALL_INT Error;
 
 /*
  *  Indication of PC wrap around
  */
-FLAG PcWrapped;
+PER_INSTANCE FLAG PcWrapped;
 
 /*
  *  Currently executed function
  */
-s_opcode XeqOpCode;
+PER_INSTANCE s_opcode XeqOpCode;
 
 /*
  *  Temporary display (not X)
  */
-SMALL_INT ShowRegister;
+PER_INSTANCE SMALL_INT ShowRegister;
 
 /*
  *  User code being called from XROM
  */
-SMALL_INT XromUserPc;
-SMALL_INT UserLocalRegs;
+PER_INSTANCE SMALL_INT XromUserPc;
+PER_INSTANCE SMALL_INT UserLocalRegs;
 
 /* We need various different math contexts.
  * More efficient to define these globally and reuse them as needed.
  */
-decContext Ctx;
+PER_INSTANCE decContext Ctx;
 
 /*
  * A buffer for instruction display
  */
-char TraceBuffer[25];
+PER_INSTANCE char TraceBuffer[25];
 
 /*
  *  Total Size of the return stack
  */
-SMALL_INT RetStkSize;
+PER_INSTANCE SMALL_INT RetStkSize;
 
 /*
  *  Number of remaining program steps
  */
-SMALL_INT ProgFree;
+PER_INSTANCE SMALL_INT ProgFree;
 
 /*
  * The actual top of the return stack
  */
-unsigned short *RetStk;
+PER_INSTANCE unsigned short *RetStk;
 
 /*
  *  The location of the RPN stack
  */
-REGISTER *StackBase;
+PER_INSTANCE REGISTER *StackBase;
 
 #ifdef INFRARED
 /*
  *  Is tracing active?
  */
-FLAG Tracing;
+PER_INSTANCE FLAG Tracing;
 #endif
 
 /*
 *	Indicates that a coordinate converstion has just happened
 */
 #ifdef RP_PREFIX
-SMALL_INT RectPolConv; // 1 - R->P just done; 2 - P->R just done
+PER_INSTANCE SMALL_INT RectPolConv; // 1 - R->P just done; 2 - P->R just done
 #endif
 
 /*
@@ -264,12 +264,31 @@ static void raw_set_pc(unsigned int pc) {
 /*
  *  Where do the program regions start?
  */
+#ifndef INCLUDE_MULTI_INSTANCE
 static const s_opcode *const RegionTab[] = {
 	Prog,
 	UserFlash.prog,
 	BackupFlash._prog,
 	xrom
 };
+#else
+/*
+ *  Thread local data has no constant address, each instance fills its own table
+ */
+static const s_opcode *const *region_table(void)
+{
+	static PER_INSTANCE const s_opcode *tab[REGION_XROM + 1];
+
+	if (tab[REGION_RAM] == NULL) {
+		tab[REGION_RAM] = Prog;
+		tab[REGION_LIBRARY] = UserFlash.prog;
+		tab[REGION_BACKUP] = BackupFlash._prog;
+		tab[REGION_XROM] = xrom;
+	}
+	return tab;
+}
+#define RegionTab (region_table())
+#endif
 
 /*
  *  Size of a program segment
@@ -422,6 +441,247 @@ void decpc(void) {
 	raw_set_pc(do_dec(state_pc(), 1));
 }
 
+#ifdef INCLUDE_PROGRAM_INDEX
+/*
+ *  Index of the program regions.
+ *  Each region is scanned once on first use.  The positions of all labels
+ *  are kept sorted by opcode and address and the start of every step is
+ *  recorded to translate between addresses and user step numbers.  The
+ *  END statements are listed in address order to locate the bounds of
+ *  the current program.
+ *  The index is discarded whenever the region is modified, single step
+ *  edits in RAM are applied to the index in place.
+ */
+#define PROG_INDEX_SIZE (LIB_ADDR_MASK + 1)
+
+typedef struct _label_pos {
+	opcode op;
+	unsigned short pc;
+} LABEL_POS;
+
+static PER_INSTANCE struct _prog_index {
+	int valid;
+	unsigned short size;		// size of the region when the index was built
+	unsigned short labels;		// number of entries in label[]
+	unsigned short steps;		// number of entries in step[]
+	unsigned short ends;		// number of entries in end[]
+#ifdef INCLUDE_PREDECODED_PROGRAMS
+	int decoded;			// DecodedProg[] matches the index
+#endif
+	LABEL_POS label[PROG_INDEX_SIZE];
+	unsigned short end[PROG_INDEX_SIZE];	   // offset of each END
+	unsigned short step[PROG_INDEX_SIZE];	   // offset of each step
+	unsigned short before[PROG_INDEX_SIZE + 1]; // number of steps starting below an offset
+} ProgIndex[REGION_XROM + 1];
+
+/*
+ *  Throw away the index of a region, a negative argument discards all of them
+ */
+void invalidate_program_index(int region) {
+	int i;
+
+	for (i = 0; i <= REGION_XROM; ++i)
+		if (region < 0 || region == i)
+			ProgIndex[i].valid = 0;
+}
+
+static int is_label_opcode(const opcode op) {
+	if (isDBL(op))
+		return opDBL(op) == DBL_LBL;
+	return isRARG(op) && RARG_CMD(op) == RARG_LBL;
+}
+
+static int compare_label_pos(const void *v1, const void *v2) {
+	const LABEL_POS *const a = (const LABEL_POS *) v1;
+	const LABEL_POS *const b = (const LABEL_POS *) v2;
+
+	if (a->op != b->op)
+		return a->op < b->op ? -1 : 1;
+	return (int) a->pc - (int) b->pc;
+}
+
+/*
+ *  Return the index of a region, rebuild it if necessary
+ */
+static const struct _prog_index *get_program_index(const int region) {
+	struct _prog_index *const p = ProgIndex + region;
+	const unsigned int size = sizeLIB(region);
+
+	if (! p->valid || p->size != size) {
+		const s_opcode *const base = RegionTab[region];
+		unsigned int offset;
+
+		p->labels = 0;
+		p->steps = 0;
+		p->ends = 0;
+		for (offset = 0; offset < size; ++offset) {
+			const opcode op = get_opcode(base + offset);
+
+			p->before[offset] = p->steps;
+			p->step[p->steps++] = offset;
+			if (op == (OP_NIL | OP_END))
+				p->end[p->ends++] = offset;
+			if (is_label_opcode(op)) {
+				p->label[p->labels].op = op;
+				p->label[p->labels].pc = addrLIB(offset + 1, region);
+				++p->labels;
+			}
+			if (isDBL(op) && offset + 1 < size)
+				p->before[++offset] = p->steps;
+		}
+		p->before[size] = p->steps;
+		qsort(p->label, p->labels, sizeof(LABEL_POS), &compare_label_pos);
+#ifdef INCLUDE_PREDECODED_PROGRAMS
+		p->decoded = 0;
+#endif
+		p->size = size;
+		p->valid = 1;
+	}
+	return p;
+}
+
+/*
+ *  Find the first index entry not less than (op, pc)
+ */
+static unsigned int label_lower_bound(const struct _prog_index *p, const opcode op, const unsigned int pc) {
+	unsigned int lo = 0, hi = p->labels;
+
+	while (lo < hi) {
+		const unsigned int mid = (lo + hi) >> 1;
+		const LABEL_POS *const e = p->label + mid;
+
+		if (e->op < op || (e->op == op && e->pc < pc))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ *  Check that pc doesn't point into the second word of a double length step
+ */
+static int is_step_start(const struct _prog_index *p, const unsigned int pc) {
+	const unsigned int offset = offsetLIB(pc);
+
+	return offset >= p->size || p->step[p->before[offset]] == offset;
+}
+
+/*
+ *  Find the first END at or above offset
+ */
+static unsigned int end_lower_bound(const struct _prog_index *p, const unsigned int offset) {
+	unsigned int lo = 0, hi = p->ends;
+
+	while (lo < hi) {
+		const unsigned int mid = (lo + hi) >> 1;
+
+		if (p->end[mid] < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ *  Apply the insertion (words > 0) or deletion (words < 0) of the RAM step
+ *  at pc to the index.  Called after the program memory has been changed.
+ */
+void update_program_index(unsigned int pc, int words) {
+	struct _prog_index *const p = ProgIndex + REGION_RAM;
+	const unsigned int offset = pc - 1;
+	unsigned int i, k, e;
+
+#ifdef INCLUDE_PREDECODED_PROGRAMS
+	p->decoded = 0;
+#endif
+	if (! p->valid || p->size + words != ProgSize || offset >= p->size + (words > 0)) {
+		p->valid = 0;
+		return;
+	}
+	k = p->before[offset];
+	if (! is_step_start(p, pc)) {
+		// Not at the start of a step, the layout of the rest is unknown
+		p->valid = 0;
+		return;
+	}
+	e = end_lower_bound(p, offset);
+	if (words > 0) {
+		const opcode op = getprog(pc);
+
+		// Move everything behind the new step up
+		for (i = p->labels; i-- > 0; )
+			if (p->label[i].pc >= pc)
+				p->label[i].pc += words;
+		if (is_label_opcode(op)) {
+			i = label_lower_bound(p, op, pc);
+			xcopy(p->label + i + 1, p->label + i, (p->labels - i) * sizeof(LABEL_POS));
+			p->label[i].op = op;
+			p->label[i].pc = pc;
+			++p->labels;
+		}
+		for (i = p->steps; i > k; --i)
+			p->step[i] = p->step[i - 1] + words;
+		p->step[k] = offset;
+		++p->steps;
+		for (i = p->size; i > offset; --i)
+			p->before[i + words] = p->before[i] + 1;
+		for (i = 1; i <= (unsigned int) words; ++i)
+			p->before[offset + i] = k + 1;
+		for (i = e; i < p->ends; ++i)
+			p->end[i] += words;
+		if (op == (OP_NIL | OP_END)) {
+			xcopy(p->end + e + 1, p->end + e, (p->ends - e) * sizeof(unsigned short));
+			p->end[e] = offset;
+			++p->ends;
+		}
+	}
+	else {
+		const unsigned int n = -words;
+
+		// Drop the entries of the deleted step and move everything behind it down
+		for (i = 0; i < p->labels; ++i)
+			if (p->label[i].pc == pc) {
+				--p->labels;
+				xcopy(p->label + i, p->label + i + 1, (p->labels - i) * sizeof(LABEL_POS));
+				break;
+			}
+		for (i = 0; i < p->labels; ++i)
+			if (p->label[i].pc > pc)
+				p->label[i].pc -= n;
+		--p->steps;
+		for (i = k; i < p->steps; ++i)
+			p->step[i] = p->step[i + 1] - n;
+		for (i = offset + 1; i <= p->size - n; ++i)
+			p->before[i] = p->before[i + n] - 1;
+		if (e < p->ends && p->end[e] == offset) {
+			--p->ends;
+			xcopy(p->end + e, p->end + e + 1, (p->ends - e) * sizeof(unsigned short));
+		}
+		for (i = e; i < p->ends; ++i)
+			p->end[i] -= n;
+	}
+	p->size += words;
+}
+
+/*
+ *  Search the index for a label between top and bottom starting at pc
+ *  with wrap around.  The search order is the same as stepping through
+ *  the program with do_inc().
+ */
+static unsigned int find_indexed_label(const unsigned int pc, const opcode l, const unsigned int top, const unsigned int bottom) {
+	const struct _prog_index *const p = get_program_index(nLIB(pc));
+	unsigned int i = label_lower_bound(p, l, pc);
+
+	if (i >= p->labels || p->label[i].op != l || p->label[i].pc > bottom)
+		i = label_lower_bound(p, l, top);
+	if (i < p->labels && p->label[i].op == l && p->label[i].pc <= bottom)
+		return p->label[i].pc;
+	return 0;
+}
+#endif
+
 /*
  * Update the pointers to the current program delimited by END statements
  */
@@ -431,6 +691,24 @@ void update_program_bounds(const int force) {
 		State.pc = pc = 1;
 	if (! force && pc >= ProgBegin && pc <= ProgEnd)
 		return;
+#ifdef INCLUDE_PROGRAM_INDEX
+	if (pc != 0) {
+		const int region = nLIB(pc);
+		const struct _prog_index *const p = get_program_index(region);
+		const unsigned int offset = offsetLIB(pc);
+
+		// Only valid if the PC is at the start of a step
+		if (offset < p->size && is_step_start(p, pc)) {
+			const unsigned int e = end_lower_bound(p, offset);
+
+			ProgEnd = addrLIB((e < p->ends ? p->end[e] : p->step[p->steps - 1]) + 1, region);
+			ProgBegin = addrLIB(e > 0 ? p->end[e - 1] + 2 : 1, region);
+			// Leave PcWrapped as the backwards scan below would
+			PcWrapped = e == 0 && (region != REGION_RAM || State2.runmode);
+			return;
+		}
+	}
+#endif
 	for (PcWrapped = 0; !PcWrapped; pc = do_inc(pc, 0)) {
 		ProgEnd = pc;
 		if (getprog(pc) == (OP_NIL | OP_END)) {
@@ -451,7 +729,9 @@ void update_program_bounds(const int force) {
  */
 unsigned int user_pc(unsigned int pc) {
 	unsigned int n = 1;
+#ifndef INCLUDE_PROGRAM_INDEX
 	unsigned int base;
+#endif
 
 #ifndef REALBUILD
 	if (pc == 0 || isXROM(pc))
@@ -460,6 +740,17 @@ unsigned int user_pc(unsigned int pc) {
 	if (pc == 0)
 		return 0;
 #endif
+#ifdef INCLUDE_PROGRAM_INDEX
+	{
+		const struct _prog_index *const p = get_program_index(nLIB(pc));
+		const unsigned int offset = pc - startLIB(pc);
+
+		n = p->before[offset < p->size ? offset : p->size] + 1;
+		if (n > p->steps)
+			n = p->steps;
+		return n == 0 ? 1 : n;
+	}
+#else
 	base = startLIB(pc);
 	while (base < pc) {
 		base = do_inc(base, 0);
@@ -468,6 +759,7 @@ unsigned int user_pc(unsigned int pc) {
 		++n;
 	}
 	return n;
+#endif
 }
 
 /* Given a target user PC, figure out the real matching PC
@@ -476,11 +768,23 @@ unsigned int find_user_pc(unsigned int target) {
 	unsigned int upc = state_pc();
 	const int libp = isLIB(upc);
 	unsigned int base = libp ? startLIB(upc) : 0;
+#ifndef INCLUDE_PROGRAM_INDEX
 	unsigned int n = libp ? 1 : 0;
+#endif
 #ifndef REALBUILD
 	if (isXROM(upc))
 		return addrXROM(target);
 #endif
+#ifdef INCLUDE_PROGRAM_INDEX
+	{
+		const int region = nLIB(upc);
+		const struct _prog_index *const p = get_program_index(region);
+
+		if (target > p->steps)
+			target = p->steps;
+		return target == 0 ? base : addrLIB(p->step[target - 1] + 1, region);
+	}
+#else
 	while (n++ < target) {
 		const unsigned int oldbase = base;
 		base = do_inc(oldbase, 0);
@@ -488,6 +792,7 @@ unsigned int find_user_pc(unsigned int target) {
 			return oldbase;
 	}
 	return base;
+#endif
 }
 
 
@@ -682,7 +987,10 @@ static REGISTER *get_stack_top(void) {
 }
 
 void copyreg(REGISTER *d, const REGISTER *s) {
-	xcopy(d, s, is_dblmode() ? sizeof(decimal128) : sizeof(decimal64));
+	if (is_dblmode())
+		d->d = s->d;
+	else
+		d->s = s->s;
 }
 
 void copyreg_n(int d, int s) {
@@ -1173,7 +1481,7 @@ REGISTER *get_flash_reg_n(int n) {
  */
 REGISTER *get_const(int index, int dbl)
 {
-	static REGISTER result;
+	static PER_INSTANCE REGISTER result;
 	const int i = cnsts[index].index;
 	if (dbl) {
 		if (i <= 1 || i >= 128)
@@ -1944,6 +2252,17 @@ unsigned int find_opcode_from(unsigned int pc, const opcode l, const int flags)
 	const int errp = flags & FIND_OP_ERROR;
 
 	count = 1 + find_section_bounds(pc, endp, &top);
+#ifdef INCLUDE_PROGRAM_INDEX
+	if (pc + 1 >= top && (int) pc < count && is_label_opcode(l)
+			&& is_step_start(get_program_index(nLIB(pc)), pc)) {
+		// pc is inside the searched section, use the index
+		const unsigned int lbl = find_indexed_label(pc, l, top, count - 1);
+
+		if (lbl == 0 && errp)
+			err(ERR_NO_LBL);
+		return lbl;
+	}
+#endif
 	count -= top;
 	while (count--) {
 		// Wrap around doesn't hurt, we just limit the search to the number of possible steps
@@ -3852,6 +4171,8 @@ void cmdpause(unsigned int arg, enum rarg op) {
 	Pause = arg;
 	GoFast = (arg == 0);
 #else
+	if (batch_mode)
+		return;
 #if defined(WIN32) && !defined(__GNUC__)
 #pragma warning(disable:4996)
 	sleep(arg/10);
@@ -3914,9 +4235,10 @@ void XisPrime(enum nilop op) {
 		getX(&x);
 		if (decNumberIsSpecial(&x))
 			sgn = 1; // not prime
-		else if (dn_ge(&x, &const_2pow64))
-			// isPrime() reports domain error for numbers with bit 63 set
-			i = 0xFFFFFFFFFFFFFFFFull;
+		else if (dn_ge(&x, &const_2pow64)) {
+			err(ERR_DOMAIN);
+			return;
+		}
 	}
 	fin_tst(sgn == 0 && isPrime(i));
 }
@@ -5001,12 +5323,72 @@ static void multi(const opcode op) {
 
 
 
-/* Main dispatch routine that decodes the top level of the opcode and
- * goes to the appropriate lower level dispatch routine.
+/* Decode the top level of the opcode and return the appropriate lower
+ * level dispatch routine.
  */
-void xeq(opcode op) 
+typedef void (*FP_DISPATCH)(const opcode);
+
+static void bad_opcode(const opcode op) {
+	illegal(op);
+}
+
+static FP_DISPATCH dispatch_routine(const opcode op) {
+	if (isDBL(op))
+		return &multi;
+	if (isRARG(op))
+		return &rargs;
+	switch (opKIND(op)) {
+	case KIND_SPEC:	return &specials;
+	case KIND_NIL:	return &niladic;
+	case KIND_MON:	return &monadic;
+	case KIND_DYA:	return &dyadic;
+	case KIND_TRI:	return &triadic;
+	case KIND_CMON:	return &monadic_cmplex;
+	case KIND_CDYA:	return &dyadic_cmplex;
+	}
+	return &bad_opcode;
+}
+
+/* Check if an opcode leaves the registers saved by xeq_routine() alone so
+ * the copy can be skipped.  Only branches, tests and flag commands qualify,
+ * loop counters must be addressed directly and lie below the stack.
+ * A pending command line always ends up in X.  In single precision the copy
+ * runs on over Alpha, the random seeds and the state words.  None of these
+ * commands touch Alpha or the seeds, but branches do move the program
+ * counter and the return stack, so xeq_routine() keeps the state words
+ * separately then.
+ */
+static int keeps_stack(const opcode op) {
+	if (CmdLineLength)
+		return 0;
+	if (isDBL(op)) {
+		const int cmd = opDBL(op);
+		return cmd == DBL_LBL || cmd == DBL_LBLP || cmd == DBL_XEQ || cmd == DBL_GTO;
+	}
+	if (isRARG(op)) {
+		const unsigned int cmd = RARG_CMD(op);
+
+		if (cmd >= RARG_DSE && cmd <= RARG_INC)
+			return (op & RARG_IND) == 0 && (op & RARG_MASK) < regX_idx;
+		return (cmd >= RARG_TEST_EQ && cmd <= RARG_BSB)
+		    || (cmd >= RARG_LBL && cmd <= RARG_GTO)
+		    || (cmd >= RARG_SF && cmd <= RARG_FCF);
+	}
+	if (opKIND(op) == KIND_NIL) {
+		const unsigned int f = argKIND(op);
+		return f == OP_NOP || f == OP_RTN || f == OP_RTNp1 || f == OP_END;
+	}
+	return 0;
+}
+
+/* Main dispatch routine, executes the opcode with the lower level dispatch
+ * routine already decoded and handles errors.
+ */
+static void xeq_routine(opcode op, FP_DISPATCH fp)
 {
 	REGISTER save[STACK_SIZE+2];
+	struct _state old_state;
+	int saved, state_saved = 0, i;
 	const unsigned short flags = UserFlags[regA_idx >> 4];
 	const struct _ustate old = UState;
 	const unsigned char lift = get_lift();
@@ -5026,7 +5408,14 @@ void xeq(opcode op)
 	}
 #endif
 
-	xcopy(save, StackBase, sizeof(save));
+	saved = ! keeps_stack(op);
+	if (saved)
+		for (i = 0; i < STACK_SIZE+2; i++)
+			save[i] = StackBase[i];
+	else if (! is_dblmode()) {
+		old_state = State;
+		state_saved = 1;
+	}
 #ifdef CONSOLE
 	instruction_count++;
 #endif
@@ -5051,23 +5440,8 @@ void xeq(opcode op)
 #endif
 	Busy = 0;
 	State2.wascomplex = 0;
-	if (isDBL(op))
-		multi(op);
-	else if (isRARG(op))
-		rargs(op);
-	else {
-		XeqOpCode = (s_opcode) op;
-		switch (opKIND(op)) {
-		case KIND_SPEC:	specials(op);	break;
-		case KIND_NIL:	niladic(op);	break;
-		case KIND_MON:	monadic(op);	break;
-		case KIND_DYA:	dyadic(op);	break;
-		case KIND_TRI:	triadic(op);	break;
-		case KIND_CMON:	monadic_cmplex(op);	break;
-		case KIND_CDYA:	dyadic_cmplex(op);	break;
-		default:	illegal(op);
-		}
-	}
+	XeqOpCode = (s_opcode) op;	// multi() and rargs() replace this
+	fp(op);
 #if INTERRUPT_XROM_TICKS > 0
 	if (OnKeyTicks >= INTERRUPT_XROM_TICKS) {
 		err(ERR_INTERRUPTED);
@@ -5080,7 +5454,11 @@ void xeq(opcode op)
 		error_message( Error );
 		// Repair stack and state
 		// Clear return stack
-		xcopy(StackBase, save, sizeof(save));
+		if (saved)
+			for (i = 0; i < STACK_SIZE+2; i++)
+				StackBase[i] = save[i];
+		else if (state_saved)
+			State = old_state;
 		UserFlags[regA_idx >> 4] = flags;
 		UState = old;
 		State2.state_lift = lift;
@@ -5151,13 +5529,104 @@ void xeq(opcode op)
 #endif
 }
 
+void xeq(opcode op)
+{
+	xeq_routine(op, dispatch_routine(op));
+}
+
+#ifdef INCLUDE_BENCHMARKS
+/*
+ *  Execute a monadic real command through an XROM routine in place of its
+ *  C function, the console checks the native distributions this way.
+ */
+static PER_INSTANCE void *XromMonadic;
+
+static void monadic_xrom(const opcode op) {
+	process_cmdline_set_lift();
+	dispatch_xrom(XromMonadic);
+}
+
+void xeq_xrom_monadic(opcode op, void *fp)
+{
+	XromMonadic = fp;
+	xeq_routine(op, &monadic_xrom);
+}
+#endif
+
+#ifdef INCLUDE_PREDECODED_PROGRAMS
+/*
+ *  Decoded copies of the program regions: every step holds the full opcode
+ *  and its dispatch routine.  A region is decoded on the first step executed
+ *  from it and again after the program index has been rebuilt or changed.
+ */
+static PER_INSTANCE struct _decoded_step {
+	opcode op;
+	FP_DISPATCH fp;
+} DecodedProg[REGION_XROM + 1][PROG_INDEX_SIZE];
+
+/*
+ *  Return the decoded step at pc or NULL if the caller has to fetch it
+ */
+static const struct _decoded_step *get_decoded_step(const unsigned int pc) {
+	const int region = nLIB(pc);
+	const struct _prog_index *const p = get_program_index(region);
+	const unsigned int offset = offsetLIB(pc);
+
+	if (pc == 0 || offset >= p->size || ! is_step_start(p, pc))
+		return NULL;
+	if (! p->decoded) {
+		const s_opcode *const base = RegionTab[region];
+		struct _decoded_step *const d = DecodedProg[region];
+		unsigned int i;
+
+		for (i = 0; i < p->size; i += 1 + isDBL(d[i].op)) {
+			d[i].op = get_opcode(base + i);
+			d[i].fp = dispatch_routine(d[i].op);
+		}
+		ProgIndex[region].decoded = 1;
+	}
+	return DecodedProg[region] + offset;
+}
+#endif
+
 /* Execute a single step and return.
  */
 static void xeq_single(void) {
-	const opcode op = getprog(state_pc());
+	const unsigned int pc = state_pc();
+	opcode op;
+	FP_DISPATCH fp;
+#ifdef INCLUDE_PREDECODED_PROGRAMS
+	const struct _decoded_step *const d = get_decoded_step(pc);
 
-	incpc();
-	xeq(op);
+	if (d != NULL) {
+		const unsigned int npc = pc + 1 + isDBL(d->op);
+
+		op = d->op;
+		fp = d->fp;
+		if (pc >= ProgBegin && npc <= ProgEnd) {
+			// No wrap around and still inside the current program
+			PcWrapped = 0;
+			State.pc = npc;
+		}
+		else
+			incpc();
+	}
+	else
+#endif
+	{
+		op = getprog(pc);
+		fp = dispatch_routine(op);
+		incpc();
+	}
+#ifdef INCLUDE_PROFILER
+	if (profiling) {
+		profile_enter(pc, op);
+		xeq_routine(op, fp);
+		profile_leave();
+		return;
+	}
+#endif
+	xeq_routine(op, fp);
 }
 
 /* Continue execution trough xrom code
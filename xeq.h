@@ -644,9 +644,6 @@ enum {
         OP_ZETA, OP_Bn, OP_BnS,
 #ifdef INCLUDE_EASTER
         OP_EASTER,
-#endif
-#ifdef INCLUDE_FACTOR
-        OP_FACTOR,
 #endif
         OP_DATE_YEAR, OP_DATE_MONTH, OP_DATE_DAY,
 #ifdef INCLUDE_USER_IO
@@ -664,6 +661,9 @@ enum {
 #endif
 #ifdef INCLUDE_XROM_DIGAMMA
         OP_DIGAMMA,
+#endif
+#ifdef INCLUDE_FACTOR
+        OP_FACTOR,
 #endif
         NUM_MONADIC     // Last entry defines number of operations
 };
@@ -735,6 +735,9 @@ enum {
 
 #ifdef INCLUDE_INT_MODULO_OPS
         OP_MULMOD, OP_EXPMOD,
+#endif
+#ifdef MATRIX_LU_DECOMP
+        OP_MAT_LU_SOLVE,
 #endif
         NUM_TRIADIC     // Last entry defines number of operations
 };  
@@ -833,16 +836,16 @@ enum nilop {
         /* end of INFRARED commands */
 
         OP_QUERY_XTAL, OP_QUERY_PRINT,
-#if defined(INCLUDE_YREG_CODE) && !defined(YREG_ALWAYS_ON)
-	OP_SHOWY, OP_HIDEY,
-#endif
 
-#ifdef INCLUDE_STOPWATCH
+        /* The optional commands keep their slots in every build so the
+         * opcodes after them do not depend on the configuration */
+	OP_SHOWY, OP_HIDEY,
         OP_STOPWATCH,
-#endif // INCLUDE_STOPWATCH
-#ifdef _DEBUG
         OP_DEBUG,
-#endif
+
+        OP_SLVI, OP_SLVS,
+        OP_INTI, OP_INTS,
+        OP_SUMS, OP_PRDS,
         NUM_NILADIC,    // Last entry defines number of operations
 
         // following are dummy operations for internal use
@@ -1136,6 +1139,9 @@ extern enum shifts reset_shift(void);
 extern void init_state(void);
 extern void reset_volatile_state(void);
 extern void xeq(opcode);
+#ifdef INCLUDE_BENCHMARKS
+extern void xeq_xrom_monadic(opcode, void *);
+#endif
 extern void xeqprog(void);
 extern void xeq_xrom(void);
 extern void xeqone(char *);
@@ -1173,6 +1179,13 @@ extern void decpc(void);
 #define FIND_OP_ERROR   1
 #define FIND_OP_ENDS    2
 extern unsigned int find_opcode_from(unsigned int pc, const opcode l, const int flags);
+#ifdef INCLUDE_PROGRAM_INDEX
+extern void invalidate_program_index(int region);
+extern void update_program_index(unsigned int pc, int words);
+#else
+#define invalidate_program_index(region)
+#define update_program_index(pc, words)
+#endif
 extern unsigned int find_label_from(unsigned int, unsigned int, int);
 extern unsigned int findmultilbl(const opcode, int);
 extern void fin_tst(const int);
@@ -1436,6 +1449,10 @@ extern enum shifts shift_down(void);
 extern int get_key(void);
 extern int put_key(int k);
 extern void shutdown(void);
+#ifdef INCLUDE_PROFILER
+extern void profile_enter(unsigned int pc, opcode op);
+extern void profile_leave(void);
+#endif
 #ifdef REALBUILD
 extern void lock(void);
 extern void unlock(void);